@@ -0,0 +1,45 @@
+#include "evaluators.h"
+#include <iostream>
+
+/**
+ * Fills the board bank for one board size and evaluator with pre-generated boards, so that the game can pick them at the first click instead of generating them.
+ * Each board is started by revealing a random cell, which gives the board its opening.
+ * Usage: bankgen <rows> <cols> <mines> <evaluator> <number of boards to add>
+ */
+int main(int argc, char* argv[]) {
+	if(argc != 6 || evaluators::evaluator.find(argv[4]) == evaluators::evaluator.end()) {
+		cerr << "Usage: bankgen <rows> <cols> <mines> <random|safeStart|safeStartPlus|noGuess> <number of boards to add>" << endl;
+		return 1;
+	}
+	
+	const short rows = stoi(argv[1]);
+	const short cols = stoi(argv[2]);
+	const int mines = stoi(argv[3]);
+	const string evaluatorName = argv[4];
+	const int boardsToAdd = stoi(argv[5]);
+	
+	//The solver logs every step it takes, which would fill the log file with nothing of interest
+	LOGGER.clear();
+	
+	try {
+		boardbank::BankWriter writer(boardbank::fileName(rows, cols, mines, evaluatorName), rows, cols, mines);
+		const unsigned generationThreads = max(1u, thread::hardware_concurrency());
+		
+		for(int board = 0; board < boardsToAdd; board++) {
+			Minefield minefield(COORD{cols, rows}, mines, COORD{0, 0}, &evaluators::evaluator[evaluatorName], generationThreads);
+			minefield.revealSpace(
+					uniform_int_distribution<short>(0, rows - 1)(randomizer),
+					uniform_int_distribution<short>(0, cols - 1)(randomizer)
+			);
+			minefield.appendTo(writer);
+			
+			cout << "\r" << writer.size() << " boards in bank" << flush;
+		}
+		cout << endl;
+	} catch(const exception& e) {
+		cerr << endl << "FATAL ERROR: " << e.what() << endl;
+		return 1;
+	}
+	
+	return 0;
+}
\ No newline at end of file
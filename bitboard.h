@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * Utilities for grids stored as one bit per cell, with each row padded to a
+ * whole number of 64-bit words (bit b of word w in a row is column 64w+b).
+ *
+ * The neighbor counting kernel treats the 8 neighbors of every cell as 8
+ * shifted copies of the grid, and adds them together with a bit-sliced adder
+ * network: one AND/OR/XOR instruction sums a bit for 64 cells at once (or
+ * 128/256 cells when SSE2/AVX2 registers are available). The resulting 4
+ * bit-planes hold each cell's count in binary, which is then expanded into
+ * one byte per cell.
+ */
+namespace bitboard {
+
+// Minimum number of cells before counting is split into row bands on several threads
+constexpr long long PARALLEL_THRESHOLD = 1 << 20;
+
+// Number of rows of scratch space countNeighbors needs for each row band
+constexpr int SCRATCH_ROWS = 11;
+
+// Lane types: a group of words which the adder network processes with single instructions
+
+struct ScalarLane {
+	static constexpr int WORDS = 1;
+	std::uint64_t value;
+	
+	static ScalarLane load(const std::uint64_t* source) { return {*source}; }
+	void store(std::uint64_t* destination) const { *destination = value; }
+	
+	friend ScalarLane operator&(const ScalarLane& a, const ScalarLane& b) { return {a.value & b.value}; }
+	friend ScalarLane operator|(const ScalarLane& a, const ScalarLane& b) { return {a.value | b.value}; }
+	friend ScalarLane operator^(const ScalarLane& a, const ScalarLane& b) { return {a.value ^ b.value}; }
+};
+
+#if defined(__AVX2__)
+struct VectorLane {
+	static constexpr int WORDS = 4;
+	__m256i value;
+	
+	static VectorLane load(const std::uint64_t* source) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source))}; }
+	void store(std::uint64_t* destination) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), value); }
+	
+	friend VectorLane operator&(const VectorLane& a, const VectorLane& b) { return {_mm256_and_si256(a.value, b.value)}; }
+	friend VectorLane operator|(const VectorLane& a, const VectorLane& b) { return {_mm256_or_si256(a.value, b.value)}; }
+	friend VectorLane operator^(const VectorLane& a, const VectorLane& b) { return {_mm256_xor_si256(a.value, b.value)}; }
+};
+#elif defined(__SSE2__)
+struct VectorLane {
+	static constexpr int WORDS = 2;
+	__m128i value;
+	
+	static VectorLane load(const std::uint64_t* source) { return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(source))}; }
+	void store(std::uint64_t* destination) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), value); }
+	
+	friend VectorLane operator&(const VectorLane& a, const VectorLane& b) { return {_mm_and_si128(a.value, b.value)}; }
+	friend VectorLane operator|(const VectorLane& a, const VectorLane& b) { return {_mm_or_si128(a.value, b.value)}; }
+	friend VectorLane operator^(const VectorLane& a, const VectorLane& b) { return {_mm_xor_si128(a.value, b.value)}; }
+};
+#else
+using VectorLane = ScalarLane;
+#endif
+
+/**
+ * Add 8 one-bit inputs for every bit position of the lane starting at the given word, producing a 4-bit sum (0-8) as 4 bit-planes.
+ */
+template<typename Lane>
+void addEightInputs(const std::uint64_t* const inputs[8], std::uint64_t* const planes[4], const int& word) {
+	Lane in[8];
+	for(int i = 0; i < 8; i++) {
+		in[i] = Lane::load(inputs[i] + word);
+	}
+	
+	// Three full/half adders reduce the 8 inputs to partial sums of weight 1 and carries of weight 2
+	const Lane sumA = in[0] ^ in[1] ^ in[2];
+	const Lane carryA = (in[0] & in[1]) | (in[2] & (in[0] ^ in[1]));
+	const Lane sumB = in[3] ^ in[4] ^ in[5];
+	const Lane carryB = (in[3] & in[4]) | (in[5] & (in[3] ^ in[4]));
+	const Lane sumC = in[6] ^ in[7];
+	const Lane carryC = in[6] & in[7];
+	
+	// Weight 1: add the three partial sums
+	const Lane ones = sumA ^ sumB ^ sumC;
+	const Lane carryD = (sumA & sumB) | (sumC & (sumA ^ sumB));
+	
+	// Weight 2: add the four carries
+	const Lane sumE = carryA ^ carryB ^ carryC;
+	const Lane carryE = (carryA & carryB) | (carryC & (carryA ^ carryB));
+	const Lane twos = sumE ^ carryD;
+	const Lane carryF = sumE & carryD;
+	
+	// Weight 4 and 8: add the two remaining carries
+	const Lane fours = carryE ^ carryF;
+	const Lane eights = carryE & carryF;
+	
+	ones.store(planes[0] + word);
+	twos.store(planes[1] + word);
+	fours.store(planes[2] + word);
+	eights.store(planes[3] + word);
+}
+
+/**
+ * Count, for every cell in rows [firstRow, lastRow), how many of its 8 neighbors have their bit set.
+ * @param bits is the grid, rows * wordsPerRow words. Bits past the last column of each row must be zero.
+ * @param counts receives one byte per cell, in row-major order (row * cols + col).
+ * @param scratch is SCRATCH_ROWS * wordsPerRow words kept by the caller, so that counting allocates nothing. Its last row must be zero, and stays so.
+ */
+void countNeighbors(const std::uint64_t* bits, const int& rows, const int& cols, const int& wordsPerRow, const int& firstRow, const int& lastRow, unsigned char* counts, std::uint64_t* scratch) {
+	// Scratch rows: 6 shifted inputs (the unshifted rows above and below are read in place), 4 output planes, and a zero row for the field edges
+	std::uint64_t* shifted[6];
+	std::uint64_t* planes[4];
+	for(int i = 0; i < 6; i++) {
+		shifted[i] = scratch + i * wordsPerRow;
+	}
+	for(int i = 0; i < 4; i++) {
+		planes[i] = scratch + (6 + i) * wordsPerRow;
+	}
+	const std::uint64_t* zeroRow = scratch + 10 * wordsPerRow;
+	
+	for(int row = firstRow; row < lastRow; row++) {
+		const std::uint64_t* above = row > 0 ? bits + (row - 1) * wordsPerRow : zeroRow;
+		const std::uint64_t* middle = bits + row * wordsPerRow;
+		const std::uint64_t* below = row < rows - 1 ? bits + (row + 1) * wordsPerRow : zeroRow;
+		const std::uint64_t* sourceRows[3] = {above, middle, below};
+		
+		// West input: bit c holds column c-1. East input: bit c holds column c+1.
+		for(int source = 0; source < 3; source++) {
+			const std::uint64_t* x = sourceRows[source];
+			for(int word = 0; word < wordsPerRow; word++) {
+				shifted[source * 2][word] = (x[word] << 1) | (word > 0 ? x[word - 1] >> 63 : 0);
+				shifted[source * 2 + 1][word] = (x[word] >> 1) | (word + 1 < wordsPerRow ? x[word + 1] << 63 : 0);
+			}
+		}
+		
+		const std::uint64_t* const inputs[8] = {
+			shifted[0], above, shifted[1],
+			shifted[2],        shifted[3],
+			shifted[4], below, shifted[5]
+		};
+		
+		int word = 0;
+		for(; word + VectorLane::WORDS <= wordsPerRow; word += VectorLane::WORDS) {
+			addEightInputs<VectorLane>(inputs, planes, word);
+		}
+		for(; word < wordsPerRow; word++) {
+			addEightInputs<ScalarLane>(inputs, planes, word);
+		}
+		
+		// Expand the bit-planes into one count byte per cell
+		unsigned char* rowCounts = counts + row * cols;
+		for(int col = 0; col < cols; col++) {
+			const int planeWord = col / 64;
+			const int bit = col % 64;
+			rowCounts[col] = ((planes[0][planeWord] >> bit) & 1)
+					| ((planes[1][planeWord] >> bit) & 1) << 1
+					| ((planes[2][planeWord] >> bit) & 1) << 2
+					| ((planes[3][planeWord] >> bit) & 1) << 3;
+		}
+	}
+}
+
+/**
+ * @return the number of row bands forEachRowBand() splits a grid of the given size into: one per hardware thread for large grids, otherwise 1.
+ */
+int numRowBands(const int& rows, const int& cols) {
+	return std::min<long long>({
+			std::max(1u, std::thread::hardware_concurrency()),
+			rows,
+			static_cast<long long>(rows) * cols / PARALLEL_THRESHOLD + 1
+	});
+}
+
+/**
+ * Call processRows(band, firstRow, lastRow) over numRowBands() bands of rows that together cover [0, rows).
+ * Large grids are split into one band per hardware thread; small grids are processed as a single band on the calling thread.
+ */
+template<typename Function>
+void forEachRowBand(const int& rows, const int& cols, Function&& processRows) {
+	const int numThreads = numRowBands(rows, cols);
+	
+	if(numThreads <= 1) {
+		processRows(0, 0, rows);
+		return;
+	}
+	
+	std::vector<std::thread> workers;
+	for(int band = 0; band < numThreads; band++) {
+		const int firstRow = static_cast<long long>(rows) * band / numThreads;
+		const int lastRow = static_cast<long long>(rows) * (band + 1) / numThreads;
+		workers.emplace_back([&processRows, band, firstRow, lastRow]() {
+			processRows(band, firstRow, lastRow);
+		});
+	}
+	for(std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+}
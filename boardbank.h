@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <windows.h>
+
+/**
+ * Banks of pre-generated boards, stored on disk so that boards which are expensive to generate
+ * (e.g. no-guess boards) can be picked at the first click instead of generated.
+ *
+ * A bank file holds boards for one combination of rows, cols, mines and evaluator. After a fixed
+ * header, each board is stored as two grids in the layout used by bitboard.h (one bit per cell,
+ * each row padded to a whole number of 64-bit words): the mine layer, then the opening layer.
+ * The opening marks the cells which reveal exactly the same region as the board's first click did,
+ * so the board suits any first click which lands in its opening. Reflecting the board (and
+ * transposing it, when square) gives up to 8 different openings for every stored board.
+ */
+namespace boardbank {
+
+constexpr char MAGIC[8] = "MSBANK1";
+
+struct Header {
+	char magic[8];
+	std::int32_t rows;
+	std::int32_t cols;
+	std::int32_t mines;
+	std::int32_t wordsPerRow;
+	std::uint64_t boardCount;
+};
+
+/**
+ * @return the path of the bank file for the given board parameters and evaluator name.
+ */
+std::string fileName(const int& rows, const int& cols, const int& mines, const std::string& evaluatorName) {
+	return "bank-" + std::to_string(rows) + "x" + std::to_string(cols) + "-" + std::to_string(mines) + "-" + evaluatorName + ".dat";
+}
+
+/**
+ * Read-only bank of boards, memory-mapped from its file.
+ * A bank whose file is missing, truncated, or made for other board parameters holds no boards.
+ */
+class BoardBank {
+	private:
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+		const void* view = nullptr;
+		
+		int rows = 0;
+		int cols = 0;
+		int wordsPerRow = 0;
+		const std::uint64_t* boards = nullptr;
+		std::uint64_t boardCount = 0;
+		
+		/**
+		 * @return whether the given cell's bit is set in the given layer, after applying the given symmetry to the cell's position.
+		 * Bit 0 of the symmetry reflects rows, bit 1 reflects columns, and bit 2 transposes (square boards only).
+		 */
+		bool testBit(const std::uint64_t* layer, const int& symmetry, int row, int col) const {
+			if(symmetry & 4) {
+				std::swap(row, col);
+			}
+			if(symmetry & 1) {
+				row = rows - 1 - row;
+			}
+			if(symmetry & 2) {
+				col = cols - 1 - col;
+			}
+			return (layer[row * wordsPerRow + col / 64] >> (col % 64)) & 1;
+		}
+		
+		const std::uint64_t* layer(const std::uint64_t& board, const int& layerNumber) const {
+			return boards + (board * 2 + layerNumber) * rows * wordsPerRow;
+		}
+	
+	public:
+		BoardBank(const std::string& path, const int& desiredRows, const int& desiredCols, const int& desiredMines) {
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if(file == INVALID_HANDLE_VALUE) {
+				return;
+			}
+			
+			LARGE_INTEGER fileSize;
+			if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+				return;
+			}
+			
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if(mapping == nullptr) {
+				return;
+			}
+			view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if(view == nullptr) {
+				return;
+			}
+			
+			const Header* header = static_cast<const Header*>(view);
+			const int desiredWordsPerRow = (desiredCols + 63) / 64;
+			if(std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+					|| header->rows != desiredRows
+					|| header->cols != desiredCols
+					|| header->mines != desiredMines
+					|| header->wordsPerRow != desiredWordsPerRow) {
+				return;
+			}
+			
+			rows = desiredRows;
+			cols = desiredCols;
+			wordsPerRow = desiredWordsPerRow;
+			boards = reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(view) + sizeof(Header));
+			
+			//Never trust the header's count beyond what the file actually holds
+			const std::uint64_t boardBytes = 2 * sizeof(std::uint64_t) * rows * wordsPerRow;
+			boardCount = std::min<std::uint64_t>(header->boardCount, (fileSize.QuadPart - sizeof(Header)) / boardBytes);
+		}
+		
+		~BoardBank() {
+			if(view != nullptr) {
+				UnmapViewOfFile(view);
+			}
+			if(mapping != nullptr) {
+				CloseHandle(mapping);
+			}
+			if(file != INVALID_HANDLE_VALUE) {
+				CloseHandle(file);
+			}
+		}
+		
+		BoardBank(const BoardBank&) = delete;
+		void operator=(const BoardBank&) = delete;
+		
+		const std::uint64_t size() const {
+			return boardCount;
+		}
+		
+		/**
+		 * @return the number of distinct symmetries which can be applied to the bank's boards.
+		 */
+		const int symmetries() const {
+			return rows == cols ? 8 : 4;
+		}
+		
+		const bool hasMine(const std::uint64_t& board, const int& symmetry, const int& row, const int& col) const {
+			return testBit(layer(board, 0), symmetry, row, col);
+		}
+		
+		const bool isInOpening(const std::uint64_t& board, const int& symmetry, const int& row, const int& col) const {
+			return testBit(layer(board, 1), symmetry, row, col);
+		}
+};
+
+/**
+ * Appends boards to a bank file, creating the file if needed.
+ * The header's board count is rewritten after every board, so an interrupted run still leaves a valid bank.
+ */
+class BankWriter {
+	private:
+		std::fstream file;
+		Header header;
+	
+	public:
+		BankWriter(const std::string& path, const int& rows, const int& cols, const int& mines) {
+			file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+			if(!file.is_open()) {
+				std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+				header.rows = rows;
+				header.cols = cols;
+				header.mines = mines;
+				header.wordsPerRow = (cols + 63) / 64;
+				header.boardCount = 0;
+				
+				std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(&header), sizeof(Header));
+				file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+			}
+			else if(!file.read(reinterpret_cast<char*>(&header), sizeof(Header))
+					|| std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+					|| header.rows != rows
+					|| header.cols != cols
+					|| header.mines != mines) {
+				throw std::runtime_error("Existing bank file " + path + " was not made for these board parameters");
+			}
+			
+			if(!file.is_open()) {
+				throw std::runtime_error("Could not open bank file " + path);
+			}
+		}
+		
+		const std::uint64_t size() const {
+			return header.boardCount;
+		}
+		
+		/**
+		 * Append one board to the bank.
+		 * @param mineLayer and openingLayer are grids of rows * wordsPerRow words each.
+		 */
+		void append(const std::uint64_t* mineLayer, const std::uint64_t* openingLayer) {
+			const std::streamsize layerBytes = sizeof(std::uint64_t) * header.rows * header.wordsPerRow;
+			file.seekp(sizeof(Header) + 2 * layerBytes * header.boardCount);
+			file.write(reinterpret_cast<const char*>(mineLayer), layerBytes);
+			file.write(reinterpret_cast<const char*>(openingLayer), layerBytes);
+			
+			header.boardCount++;
+			file.seekp(0);
+			file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+			file.flush();
+		}
+};
+
+}
@@ -0,0 +1,6 @@
+@echo OFF
+g++ bankgen.cpp -o bankgen.exe -std=c++17 -static-libstdc++ -static-libgcc %*
+if errorlevel 1 (
+   echo Compilation failed: error code #%errorlevel%
+   cmd /k
+)
\ No newline at end of file
@@ -1,5 +1,5 @@
 @echo OFF
-g++ ms.cpp -o ms.exe ms.res -std=c++17 -static-libstdc++ -static-libgcc -Wl,--stack,1073741824 %*
+g++ ms.cpp -o ms.exe ms.res -std=c++17 -static-libstdc++ -static-libgcc %*
 if errorlevel 1 (
    echo Compilation failed: error code #%errorlevel%
    cmd /k
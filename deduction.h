@@ -0,0 +1,970 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Pluggable deduction stages for the solver.
+ *
+ * A stage is handed the whole frontier at once (every possibility set as a constraint, as used by
+ * probability.h, which must be included first) and returns the hidden cells whose state is forced.
+ * Stages may keep state between calls, e.g. what they have learned about the current game.
+ * The solver tries its own cheap rules first, and only runs its stages once those find no move,
+ * so a stage may spend more time per call than the rules do.
+ */
+namespace deduction {
+
+struct Frontier {
+	std::vector<probability::Constraint> constraints;
+	int interiorCells = 0;					//number of hidden, unflagged cells which appear in no constraint
+	int remainingMines = 0;					//number of mines among all hidden, unflagged cells
+};
+
+struct Deductions {
+	std::vector<int> safe;					//identifiers of cells which cannot be mines
+	std::vector<int> mines;					//identifiers of cells which must be mines
+	
+	bool empty() const {
+		return safe.empty() && mines.empty();
+	}
+};
+
+class Stage {
+	public:
+		virtual ~Stage() = default;
+		
+		virtual const char* name() const = 0;
+		
+		/**
+		 * @return the cells whose state is forced by the frontier. Cells which the stage cannot decide are left out.
+		 * @throws logic_error if the frontier contradicts itself.
+		 */
+		virtual Deductions deduce(const Frontier& frontier) = 0;
+		
+		/**
+		 * Drop anything kept from earlier calls, because the board has changed (e.g. a mine was moved) and earlier frontiers may no longer hold.
+		 */
+		virtual void forget() {}
+};
+
+// Flags of a pattern table entry: the cells of a group which are forced in a pair of overlapping constraints (see Patterns)
+constexpr std::uint8_t ONLY_FIRST_SAFE = 1 << 0;
+constexpr std::uint8_t ONLY_FIRST_MINES = 1 << 1;
+constexpr std::uint8_t SHARED_SAFE = 1 << 2;
+constexpr std::uint8_t SHARED_MINES = 1 << 3;
+constexpr std::uint8_t ONLY_SECOND_SAFE = 1 << 4;
+constexpr std::uint8_t ONLY_SECOND_MINES = 1 << 5;
+
+// Group sizes and mine counts in the pattern table run from 0 to 8, the most hidden cells a number can have around it
+constexpr int PATTERN_RADIX = 9;
+constexpr int PATTERN_TABLE_SIZE = PATTERN_RADIX * PATTERN_RADIX * PATTERN_RADIX * PATTERN_RADIX * PATTERN_RADIX;
+
+constexpr int patternKey(const int& onlyFirst, const int& shared, const int& onlySecond, const int& firstMines, const int& secondMines) {
+	return (((onlyFirst * PATTERN_RADIX + shared) * PATTERN_RADIX + onlySecond) * PATTERN_RADIX + firstMines) * PATTERN_RADIX + secondMines;
+}
+
+/**
+ * Build the pattern table by enumerating, for every key, each number of mines the shared cells could hold.
+ * The cells within a group are interchangeable, so the number of mines in each group is all that needs enumerating.
+ */
+constexpr std::array<std::uint8_t, PATTERN_TABLE_SIZE> makePatternTable() {
+	std::array<std::uint8_t, PATTERN_TABLE_SIZE> table{};
+	for(int onlyFirst = 0; onlyFirst < PATTERN_RADIX; onlyFirst++) {
+		for(int shared = 0; shared < PATTERN_RADIX; shared++) {
+			for(int onlySecond = 0; onlySecond < PATTERN_RADIX; onlySecond++) {
+				for(int firstMines = 0; firstMines < PATTERN_RADIX; firstMines++) {
+					for(int secondMines = 0; secondMines < PATTERN_RADIX; secondMines++) {
+						// Range of mines the shared cells can hold, leaving each constraint's other cells a number of mines they can hold
+						int fewestShared = -1;
+						int mostShared = -1;
+						for(int sharedMines = 0; sharedMines <= shared; sharedMines++) {
+							if(sharedMines <= firstMines && firstMines - sharedMines <= onlyFirst
+									&& sharedMines <= secondMines && secondMines - sharedMines <= onlySecond) {
+								if(fewestShared < 0) {
+									fewestShared = sharedMines;
+								}
+								mostShared = sharedMines;
+							}
+						}
+						if(fewestShared < 0) {
+							continue; //the pair contradicts itself, which is left to the stages that prove it
+						}
+						
+						std::uint8_t entry = 0;
+						if(onlyFirst > 0) {
+							entry |= firstMines - fewestShared == 0 ? ONLY_FIRST_SAFE : 0;
+							entry |= firstMines - mostShared == onlyFirst ? ONLY_FIRST_MINES : 0;
+						}
+						if(shared > 0) {
+							entry |= mostShared == 0 ? SHARED_SAFE : 0;
+							entry |= fewestShared == shared ? SHARED_MINES : 0;
+						}
+						if(onlySecond > 0) {
+							entry |= secondMines - fewestShared == 0 ? ONLY_SECOND_SAFE : 0;
+							entry |= secondMines - mostShared == onlySecond ? ONLY_SECOND_MINES : 0;
+						}
+						table[patternKey(onlyFirst, shared, onlySecond, firstMines, secondMines)] = entry;
+					}
+				}
+			}
+		}
+	}
+	return table;
+}
+
+constexpr std::array<std::uint8_t, PATTERN_TABLE_SIZE> PATTERN_TABLE = makePatternTable();
+
+/**
+ * Finds the moves of the local patterns people look for (1-2, 1-2-1, 1-2-2-1, and the like along a wall), by table lookup.
+ *
+ * Each of those patterns comes down to two numbers whose possibility sets overlap, which are always
+ * within a 5x5 window of each other. What the window shows only matters through three counts: the
+ * hidden cells only the first number sees, those both see, and those only the second sees, along
+ * with each number's mines left after its flags. Those counts are the key into PATTERN_TABLE, which
+ * is generated at compile time, and whose entry says which groups must be all safe or all mines.
+ * Longer patterns such as 1-2-1 are solved one pair at a time, as the solver makes the moves.
+ *
+ * The solver already finds the moves of a set contained in another one, so this stage is for sets
+ * which only partly overlap. It is far cheaper than the stages which look at the whole frontier,
+ * so it should run before them, which means it runs on every call the solver makes to its stages.
+ * So only pairs with a constraint that changed since the last call are looked up (the others gave
+ * the same entries then, whose moves have been made since), and all storage is kept between calls.
+ */
+class Patterns final : public Stage {
+	private:
+		/**
+		 * A frontier's constraints, each with its cells sorted, stored flat so that the storage is reused from one call to the next.
+		 */
+		struct Constraints {
+			std::vector<int> cells;									//every constraint's cells, one constraint after another
+			std::vector<int> offsets = {0};							//[constraint] where its cells start in cells, followed by where the last one ends
+			std::vector<int> mines;									//[constraint] number of mines among its cells
+			std::vector<std::uint64_t> hashes;						//[constraint] hash of its cells and mines
+			std::vector<std::pair<std::uint64_t, int>> byHash;		//every constraint with its hash, sorted by hash
+			
+			int size() const {
+				return mines.size();
+			}
+			
+			std::vector<int>::const_iterator begin(const int& constraint) const {
+				return cells.begin() + offsets[constraint];
+			}
+			
+			std::vector<int>::const_iterator end(const int& constraint) const {
+				return cells.begin() + offsets[constraint + 1];
+			}
+			
+			void clear() {
+				cells.clear();
+				offsets.assign(1, 0);
+				mines.clear();
+				hashes.clear();
+				byHash.clear();
+			}
+			
+			void add(const probability::Constraint& constraint) {
+				cells.insert(cells.end(), constraint.cells.begin(), constraint.cells.end());
+				std::sort(cells.begin() + offsets.back(), cells.end());
+				
+				std::uint64_t hash = constraint.mines;
+				for(auto cell = cells.begin() + offsets.back(); cell != cells.end(); cell++) {
+					hash = (hash ^ static_cast<std::uint32_t>(*cell)) * 0x100000001B3ULL;
+				}
+				byHash.emplace_back(hash, mines.size());
+				hashes.push_back(hash);
+				mines.push_back(constraint.mines);
+				offsets.push_back(cells.size());
+			}
+			
+			/**
+			 * Sort the constraints by hash, once every constraint has been added, so that contains() can look them up.
+			 */
+			void index() {
+				std::sort(byHash.begin(), byHash.end());
+			}
+			
+			/**
+			 * @return whether one of these constraints has the same cells and mines as the given constraint of other.
+			 */
+			bool contains(const Constraints& other, const int& constraint) const {
+				const std::pair<std::uint64_t, int> key(other.hashes[constraint], 0);
+				for(auto found = std::lower_bound(byHash.begin(), byHash.end(), key); found != byHash.end() && found->first == key.first; found++) {
+					if(mines[found->second] == other.mines[constraint]
+							&& std::equal(begin(found->second), end(found->second), other.begin(constraint), other.end(constraint))) {
+						return true;
+					}
+				}
+				return false;
+			}
+		};
+		
+		Constraints current;									//the constraints of the current call, kept until the next one
+		Constraints previous;									//the constraints of the previous call, while the current one runs
+		std::vector<std::pair<int, int>> cellConstraints;		//every cell of every constraint, with the constraint, sorted by cell
+		std::vector<char> changed;								//[constraint] whether it was not among the last call's constraints
+		std::vector<int> lastComparedWith;						//[constraint] last constraint it was compared with, so each overlapping pair is looked up once
+		std::vector<int> safe;
+		std::vector<int> mines;
+		std::vector<int> onlyFirst;
+		std::vector<int> shared;
+		std::vector<int> onlySecond;
+	
+	public:
+		const char* name() const override {
+			return "Patterns";
+		}
+		
+		void forget() override {
+			current.clear(); //so that the next call finds every constraint changed
+		}
+		
+		Deductions deduce(const Frontier& frontier) override {
+			std::swap(previous, current);
+			current.clear();
+			for(const probability::Constraint& constraint : frontier.constraints) {
+				current.add(constraint);
+			}
+			current.index();
+			
+			const int numConstraints = current.size();
+			changed.resize(numConstraints);
+			cellConstraints.clear();
+			for(int constraint = 0; constraint < numConstraints; constraint++) {
+				changed[constraint] = !previous.contains(current, constraint);
+				for(auto cell = current.begin(constraint); cell != current.end(constraint); cell++) {
+					cellConstraints.emplace_back(*cell, constraint);
+				}
+			}
+			std::sort(cellConstraints.begin(), cellConstraints.end());
+			
+			lastComparedWith.assign(numConstraints, -1);
+			safe.clear();
+			mines.clear();
+			
+			// Record a group's cells as safe or as mines, if the table entry says the group is forced
+			auto record = [this](const std::uint8_t& entry, const std::vector<int>& group, const std::uint8_t& safeFlag, const std::uint8_t& minesFlag) {
+				if(entry & safeFlag) {
+					safe.insert(safe.end(), group.begin(), group.end());
+				}
+				if(entry & minesFlag) {
+					mines.insert(mines.end(), group.begin(), group.end());
+				}
+			};
+			
+			for(int first = 0; first < numConstraints; first++) {
+				for(auto cell = current.begin(first); cell != current.end(first); cell++) {
+					for(auto other = std::lower_bound(cellConstraints.begin(), cellConstraints.end(), std::make_pair(*cell, 0)); other != cellConstraints.end() && other->first == *cell; other++) {
+						const int second = other->second;
+						if(second <= first || lastComparedWith[second] == first || (!changed[first] && !changed[second])) {
+							continue;
+						}
+						lastComparedWith[second] = first;
+						
+						const int firstMines = current.mines[first];
+						const int secondMines = current.mines[second];
+						if(current.end(first) - current.begin(first) >= PATTERN_RADIX || current.end(second) - current.begin(second) >= PATTERN_RADIX
+								|| firstMines < 0 || firstMines >= PATTERN_RADIX || secondMines < 0 || secondMines >= PATTERN_RADIX) {
+							continue;
+						}
+						
+						// Split the pair's cells into groups
+						onlyFirst.clear();
+						shared.clear();
+						onlySecond.clear();
+						std::set_difference(current.begin(first), current.end(first), current.begin(second), current.end(second), std::back_inserter(onlyFirst));
+						std::set_intersection(current.begin(first), current.end(first), current.begin(second), current.end(second), std::back_inserter(shared));
+						std::set_difference(current.begin(second), current.end(second), current.begin(first), current.end(first), std::back_inserter(onlySecond));
+						
+						const std::uint8_t entry = PATTERN_TABLE[patternKey(onlyFirst.size(), shared.size(), onlySecond.size(), firstMines, secondMines)];
+						record(entry, onlyFirst, ONLY_FIRST_SAFE, ONLY_FIRST_MINES);
+						record(entry, shared, SHARED_SAFE, SHARED_MINES);
+						record(entry, onlySecond, ONLY_SECOND_SAFE, ONLY_SECOND_MINES);
+					}
+				}
+			}
+			
+			std::sort(safe.begin(), safe.end());
+			safe.erase(std::unique(safe.begin(), safe.end()), safe.end());
+			std::sort(mines.begin(), mines.end());
+			mines.erase(std::unique(mines.begin(), mines.end()), mines.end());
+			for(const int& cell : safe) {
+				if(std::binary_search(mines.begin(), mines.end(), cell)) {
+					throw std::logic_error("Frontier constraints have no solution");
+				}
+			}
+			
+			Deductions result;
+			result.safe = safe;
+			result.mines = mines;
+			return result;
+		}
+};
+
+/**
+ * Treats the frontier as a linear system (one equation per constraint, one variable per hidden cell)
+ * and reduces it by Gaussian elimination, then reads forced cells off the reduced equations.
+ *
+ * Every coefficient is kept in {-1, 0, 1}, so an equation is stored as two packed bit rows (the cells
+ * with coefficient +1 and those with -1) and rows are added or subtracted a 64-bit word at a time.
+ * An elimination step that would produce a coefficient of 2 is skipped; the system only gets less
+ * reduced, never wrong.
+ *
+ * A reduced equation forces its cells when its right hand side is at one end of its range: if it
+ * equals the number of +1 cells, those cells are all mines and the -1 cells are all safe, and
+ * the other way around when it equals minus the number of -1 cells. Forced cells are substituted
+ * back into every equation until nothing more can be read off.
+ */
+class GaussianElimination final : public Stage {
+	private:
+		// Upper bound on the number of word operations spent on elimination per call
+		const std::uint64_t maxWordOperations;
+		
+		int numVariables = 0;
+		int wordsPerRow = 0;
+		std::vector<std::uint64_t> positive;	//[row * wordsPerRow + word] cells with coefficient +1
+		std::vector<std::uint64_t> negative;	//[row * wordsPerRow + word] cells with coefficient -1
+		std::vector<int> rightHandSides;
+		
+		std::uint64_t* positiveRow(const int& row) {
+			return positive.data() + row * wordsPerRow;
+		}
+		
+		std::uint64_t* negativeRow(const int& row) {
+			return negative.data() + row * wordsPerRow;
+		}
+		
+		int coefficient(const int& row, const int& variable) {
+			const std::uint64_t mask = std::uint64_t(1) << (variable % 64);
+			return (positiveRow(row)[variable / 64] & mask) ? 1
+					: (negativeRow(row)[variable / 64] & mask) ? -1
+					: 0;
+		}
+		
+		/**
+		 * Replace the target row with target - sign * source, unless that would make a coefficient of 2 or -2.
+		 * @return whether the rows were combined.
+		 */
+		bool subtract(const int& target, const int& source, const int& sign) {
+			std::uint64_t* targetPositive = positiveRow(target);
+			std::uint64_t* targetNegative = negativeRow(target);
+			// Subtracting -1 * source is the same as subtracting source with its +1 and -1 cells swapped
+			const std::uint64_t* sourcePositive = sign > 0 ? positiveRow(source) : negativeRow(source);
+			const std::uint64_t* sourceNegative = sign > 0 ? negativeRow(source) : positiveRow(source);
+			
+			for(int word = 0; word < wordsPerRow; word++) {
+				if((targetPositive[word] & sourceNegative[word]) || (targetNegative[word] & sourcePositive[word])) {
+					return false;
+				}
+			}
+			for(int word = 0; word < wordsPerRow; word++) {
+				const std::uint64_t newPositive = (targetPositive[word] & ~sourcePositive[word]) | (sourceNegative[word] & ~targetNegative[word]);
+				const std::uint64_t newNegative = (targetNegative[word] & ~sourceNegative[word]) | (sourcePositive[word] & ~targetPositive[word]);
+				targetPositive[word] = newPositive;
+				targetNegative[word] = newNegative;
+			}
+			rightHandSides[target] -= sign * rightHandSides[source];
+			return true;
+		}
+		
+		void copyRow(const int& target, const int& source) {
+			std::copy(positiveRow(source), positiveRow(source) + wordsPerRow, positiveRow(target));
+			std::copy(negativeRow(source), negativeRow(source) + wordsPerRow, negativeRow(target));
+			rightHandSides[target] = rightHandSides[source];
+		}
+		
+		void swapRows(const int& a, const int& b) {
+			std::swap_ranges(positiveRow(a), positiveRow(a) + wordsPerRow, positiveRow(b));
+			std::swap_ranges(negativeRow(a), negativeRow(a) + wordsPerRow, negativeRow(b));
+			std::swap(rightHandSides[a], rightHandSides[b]);
+		}
+		
+		/**
+		 * Reduce the rows [firstRow, lastRow) towards reduced row echelon form.
+		 */
+		void eliminate(const int& firstRow, const int& lastRow) {
+			std::uint64_t wordOperations = 0;
+			int pivotRow = firstRow;
+			for(int variable = 0; variable < numVariables && pivotRow < lastRow; variable++) {
+				int row = pivotRow;
+				while(row < lastRow && coefficient(row, variable) == 0) {
+					row++;
+				}
+				if(row == lastRow) {
+					continue;
+				}
+				swapRows(row, pivotRow);
+				
+				const int pivotSign = coefficient(pivotRow, variable);
+				for(row = firstRow; row < lastRow; row++) {
+					const int sign = coefficient(row, variable);
+					if(row != pivotRow && sign != 0) {
+						subtract(row, pivotRow, sign * pivotSign);
+						wordOperations += wordsPerRow;
+					}
+				}
+				pivotRow++;
+				
+				if(wordOperations > maxWordOperations) {
+					return;
+				}
+			}
+		}
+		
+		/**
+		 * Read forced cells off the rows, substitute them into every row, and repeat until no more cells are forced.
+		 * @param values holds -1 for each undecided variable, and receives 0 or 1 for each forced one.
+		 */
+		void propagate(const int& numRows, std::vector<int>& values) {
+			bool changed = true;
+			while(changed) {
+				changed = false;
+				for(int row = 0; row < numRows; row++) {
+					std::uint64_t* rowPositive = positiveRow(row);
+					std::uint64_t* rowNegative = negativeRow(row);
+					int numPositive = 0;
+					int numNegative = 0;
+					for(int word = 0; word < wordsPerRow; word++) {
+						numPositive += std::bitset<64>(rowPositive[word]).count();
+						numNegative += std::bitset<64>(rowNegative[word]).count();
+					}
+					
+					const int& rightHandSide = rightHandSides[row];
+					if(rightHandSide > numPositive || rightHandSide < -numNegative) {
+						throw std::logic_error("Frontier equations have no solution");
+					}
+					if(numPositive + numNegative == 0 || (rightHandSide != numPositive && rightHandSide != -numNegative)) {
+						continue;
+					}
+					
+					// At the top of the range every +1 cell is a mine, at the bottom every -1 cell is
+					const int positiveValue = rightHandSide == numPositive ? 1 : 0;
+					for(int word = 0; word < wordsPerRow; word++) {
+						for(std::uint64_t bits = rowPositive[word]; bits != 0; bits &= bits - 1) {
+							values[word * 64 + __builtin_ctzll(bits)] = positiveValue;
+						}
+						for(std::uint64_t bits = rowNegative[word]; bits != 0; bits &= bits - 1) {
+							values[word * 64 + __builtin_ctzll(bits)] = 1 - positiveValue;
+						}
+					}
+					changed = true;
+					substitute(numRows, values);
+				}
+			}
+		}
+		
+		/**
+		 * Remove every forced variable from every row, moving its contribution to the right hand side.
+		 */
+		void substitute(const int& numRows, const std::vector<int>& values) {
+			std::vector<std::uint64_t> forced(wordsPerRow, 0);
+			std::vector<std::uint64_t> mines(wordsPerRow, 0);
+			for(int variable = 0; variable < numVariables; variable++) {
+				if(values[variable] >= 0) {
+					forced[variable / 64] |= std::uint64_t(1) << (variable % 64);
+				}
+				if(values[variable] == 1) {
+					mines[variable / 64] |= std::uint64_t(1) << (variable % 64);
+				}
+			}
+			
+			for(int row = 0; row < numRows; row++) {
+				std::uint64_t* rowPositive = positiveRow(row);
+				std::uint64_t* rowNegative = negativeRow(row);
+				for(int word = 0; word < wordsPerRow; word++) {
+					rightHandSides[row] -= std::bitset<64>(rowPositive[word] & mines[word]).count();
+					rightHandSides[row] += std::bitset<64>(rowNegative[word] & mines[word]).count();
+					rowPositive[word] &= ~forced[word];
+					rowNegative[word] &= ~forced[word];
+				}
+			}
+		}
+	
+	public:
+		GaussianElimination(const std::uint64_t& desiredMaxWordOperations = 1 << 20
+		) :		maxWordOperations(desiredMaxWordOperations) {}
+		
+		const char* name() const override {
+			return "Gaussian elimination";
+		}
+		
+		Deductions deduce(const Frontier& frontier) override {
+			// Skipped elimination steps make the result depend on the order of the equations, so put them in a fixed order.
+			// That way the same frontier always gives the same deductions, however the solver reached it
+			std::vector<probability::Constraint> constraints = frontier.constraints;
+			for(probability::Constraint& constraint : constraints) {
+				std::sort(constraint.cells.begin(), constraint.cells.end());
+			}
+			std::sort(constraints.begin(), constraints.end(), [](const probability::Constraint& a, const probability::Constraint& b) {
+				return a.cells < b.cells;
+			});
+			
+			// Number the frontier's cells as variables
+			std::vector<int> cells;
+			for(const probability::Constraint& constraint : constraints) {
+				cells.insert(cells.end(), constraint.cells.begin(), constraint.cells.end());
+			}
+			std::sort(cells.begin(), cells.end());
+			cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+			auto variableOf = [&cells](const int& cell) {
+				return std::lower_bound(cells.begin(), cells.end(), cell) - cells.begin();
+			};
+			
+			// When every hidden cell is on the frontier, the remaining mine count gives one more equation
+			const bool useMineCount = frontier.interiorCells == 0 && !cells.empty();
+			const int numEquations = constraints.size() + (useMineCount ? 1 : 0);
+			numVariables = cells.size();
+			wordsPerRow = (numVariables + 63) / 64;
+			
+			// Rows hold the equations, then a copy of them to be eliminated.
+			// Elimination can spread an equation's information across rows whose bounds are looser, so forced cells are read off the originals as well
+			const int firstEliminatedRow = numEquations;
+			const int numRows = firstEliminatedRow + numEquations;
+			positive.assign(numRows * wordsPerRow, 0);
+			negative.assign(numRows * wordsPerRow, 0);
+			rightHandSides.assign(numRows, 0);
+			
+			for(size_t row = 0; row < constraints.size(); row++) {
+				for(const int& cell : constraints[row].cells) {
+					const int variable = variableOf(cell);
+					positiveRow(row)[variable / 64] |= std::uint64_t(1) << (variable % 64);
+				}
+				rightHandSides[row] = constraints[row].mines;
+			}
+			if(useMineCount) {
+				for(int variable = 0; variable < numVariables; variable++) {
+					positiveRow(numEquations - 1)[variable / 64] |= std::uint64_t(1) << (variable % 64);
+				}
+				rightHandSides[numEquations - 1] = frontier.remainingMines;
+			}
+			for(int equation = 0; equation < numEquations; equation++) {
+				copyRow(firstEliminatedRow + equation, equation);
+			}
+			
+			std::vector<int> values(numVariables, -1);
+			propagate(numRows, values);
+			eliminate(firstEliminatedRow, numRows);
+			propagate(numRows, values);
+			
+			Deductions result;
+			for(int variable = 0; variable < numVariables; variable++) {
+				if(values[variable] == 0) {
+					result.safe.push_back(cells[variable]);
+				}
+				else if(values[variable] == 1) {
+					result.mines.push_back(cells[variable]);
+				}
+			}
+			return result;
+		}
+};
+
+/**
+ * Proof by contradiction, one cell at a time: assume a frontier cell is a mine and follow the
+ * consequences with the solver's own possibility set rules (a constraint whose mines are all
+ * placed has only safe cells left, and one with as many mines left as unknown cells has only mines
+ * left). If that ends with a constraint holding too many or too few mines, the cell is safe. Either
+ * way, the same is tried with the cell assumed safe. A cell which can be neither means the frontier
+ * contradicts itself, which is reported like any other inconsistency rather than as a move.
+ *
+ * Each assumption and its consequences are recorded in a journal, which is rolled back once the
+ * hypothesis has been tested, so nothing is copied per hypothesis and contradictions are plain
+ * status codes rather than exceptions. Hypotheses do not depend on each other, so on large
+ * frontiers they are shared out between worker threads, each with its own assignment and journal.
+ */
+class Hypotheses final : public Stage {
+	private:
+		// Minimum number of cells to test before hypotheses are tested on several threads
+		static constexpr size_t PARALLEL_THRESHOLD = 256;
+		
+		// Outcome of a cell which leads to a contradiction both as a mine and as a safe cell
+		static constexpr signed char IMPOSSIBLE = 2;
+		
+		enum Status {
+			CONSISTENT,
+			CONTRADICTION
+		};
+		
+		/**
+		 * The frontier's constraints over local cell numbers, which every worker reads but none changes.
+		 */
+		struct System {
+			std::vector<std::vector<int>> constraintCells;		//[constraint] local numbers of its cells
+			std::vector<int> constraintMines;					//[constraint] number of mines among its cells
+			std::vector<std::vector<int>> cellConstraints;		//[cell] constraints which contain the cell
+			int maxMines = 0;									//number of mines the frontier may hold at most
+			int maxSafe = 0;									//number of safe cells the frontier may hold at most
+		};
+		
+		/**
+		 * One worker's partial assignment of the frontier's cells, with the journal that undoes it.
+		 */
+		class Propagation {
+			private:
+				const System* system;
+				std::vector<signed char> values;				//[cell] 1 if a mine, 0 if safe, or UNKNOWN
+				std::vector<int> unknownCells;					//[constraint] number of its cells which are unknown
+				std::vector<int> missingMines;					//[constraint] number of its mines which are not placed yet
+				int placedMines = 0;
+				int placedSafe = 0;
+				std::vector<int> journal;						//assigned cells, in assignment order
+				std::vector<int> forcedConstraints;				//constraints whose unknown cells are forced, waiting to be propagated
+			
+			public:
+				static constexpr signed char UNKNOWN = -1;
+				
+				Propagation(const System& desiredSystem
+				) :		system(&desiredSystem),
+						values(desiredSystem.cellConstraints.size(), UNKNOWN),
+						missingMines(desiredSystem.constraintMines) {
+					for(const std::vector<int>& cells : system->constraintCells) {
+						unknownCells.push_back(cells.size());
+					}
+				}
+				
+				signed char valueOf(const int& cell) const {
+					return values[cell];
+				}
+				
+				/**
+				 * Queue the constraints which force their cells before anything is assumed.
+				 */
+				void queueForcedConstraints() {
+					for(size_t constraint = 0; constraint < unknownCells.size(); constraint++) {
+						if(unknownCells[constraint] > 0 && (missingMines[constraint] == 0 || missingMines[constraint] == unknownCells[constraint])) {
+							forcedConstraints.push_back(constraint);
+						}
+					}
+				}
+				
+				/**
+				 * Give a cell a value, and queue the constraints which that leaves forced. Every constraint of the cell is updated even when one of them is contradicted, so that rollback() can undo it.
+				 */
+				Status assign(const int& cell, const bool& isMine) {
+					if(values[cell] != UNKNOWN) {
+						return values[cell] == isMine ? CONSISTENT : CONTRADICTION;
+					}
+					values[cell] = isMine;
+					journal.push_back(cell);
+					(isMine ? placedMines : placedSafe)++;
+					
+					Status status = placedMines > system->maxMines || placedSafe > system->maxSafe ? CONTRADICTION : CONSISTENT;
+					for(const int& constraint : system->cellConstraints[cell]) {
+						unknownCells[constraint]--;
+						missingMines[constraint] -= isMine;
+						if(missingMines[constraint] < 0 || missingMines[constraint] > unknownCells[constraint]) {
+							status = CONTRADICTION;
+						}
+						else if(unknownCells[constraint] > 0 && (missingMines[constraint] == 0 || missingMines[constraint] == unknownCells[constraint])) {
+							forcedConstraints.push_back(constraint);
+						}
+					}
+					return status;
+				}
+				
+				/**
+				 * Assign the cells of every forced constraint, and of the constraints that leaves forced, until none is left.
+				 */
+				Status propagate() {
+					while(!forcedConstraints.empty()) {
+						const int constraint = forcedConstraints.back();
+						forcedConstraints.pop_back();
+						if(unknownCells[constraint] == 0) {
+							continue;
+						}
+						
+						// Assigning a forced constraint's cells the forced value keeps it forced, so the value holds for all of them
+						const bool isMine = missingMines[constraint] > 0;
+						for(const int& cell : system->constraintCells[constraint]) {
+							if(values[cell] == UNKNOWN && assign(cell, isMine) == CONTRADICTION) {
+								forcedConstraints.clear();
+								return CONTRADICTION;
+							}
+						}
+					}
+					return CONSISTENT;
+				}
+				
+				/**
+				 * Undo every assignment made since the journal had the given length.
+				 */
+				void rollback(const size_t& mark) {
+					while(journal.size() > mark) {
+						const int cell = journal.back();
+						journal.pop_back();
+						const bool isMine = values[cell];
+						values[cell] = UNKNOWN;
+						(isMine ? placedMines : placedSafe)--;
+						for(const int& constraint : system->cellConstraints[cell]) {
+							unknownCells[constraint]++;
+							missingMines[constraint] += isMine;
+						}
+					}
+				}
+				
+				/**
+				 * @return whether assuming the cell has the given value leads to a contradiction. The assignment is left as it was.
+				 */
+				bool refutes(const int& cell, const bool& isMine) {
+					const size_t mark = journal.size();
+					const bool contradiction = assign(cell, isMine) == CONTRADICTION || propagate() == CONTRADICTION;
+					forcedConstraints.clear();
+					rollback(mark);
+					return contradiction;
+				}
+		};
+	
+	public:
+		const char* name() const override {
+			return "Hypotheses";
+		}
+		
+		Deductions deduce(const Frontier& frontier) override {
+			// Number the frontier's cells in a fixed order, so that the same frontier always gives the same deductions in the same order
+			std::vector<int> cells;
+			for(const probability::Constraint& constraint : frontier.constraints) {
+				cells.insert(cells.end(), constraint.cells.begin(), constraint.cells.end());
+			}
+			std::sort(cells.begin(), cells.end());
+			cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+			
+			System system;
+			system.cellConstraints.resize(cells.size());
+			for(const probability::Constraint& constraint : frontier.constraints) {
+				std::vector<int> localCells;
+				for(const int& cell : constraint.cells) {
+					localCells.push_back(std::lower_bound(cells.begin(), cells.end(), cell) - cells.begin());
+					system.cellConstraints[localCells.back()].push_back(system.constraintCells.size());
+				}
+				system.constraintCells.push_back(localCells);
+				system.constraintMines.push_back(constraint.mines);
+			}
+			// Whatever the frontier does not hold must fit in the interior
+			system.maxMines = frontier.remainingMines;
+			system.maxSafe = cells.size() + frontier.interiorCells - frontier.remainingMines;
+			
+			// Cells which are forced before anything is assumed (the solver's rules normally leave none) are deductions as they are
+			Propagation base(system);
+			base.queueForcedConstraints();
+			if(base.propagate() == CONTRADICTION) {
+				throw std::logic_error("Frontier constraints have no solution");
+			}
+			
+			std::vector<int> candidates;
+			for(size_t cell = 0; cell < cells.size(); cell++) {
+				if(base.valueOf(cell) == Propagation::UNKNOWN) {
+					candidates.push_back(cell);
+				}
+			}
+			
+			// Test each candidate both ways, on several threads when there are enough of them
+			std::vector<signed char> outcomes(candidates.size(), Propagation::UNKNOWN);		//[candidate] 1 if it must be a mine, 0 if it must be safe, or IMPOSSIBLE
+			auto test = [&candidates, &outcomes](Propagation& propagation, const size_t& candidate) {
+				if(propagation.refutes(candidates[candidate], true)) {
+					outcomes[candidate] = propagation.refutes(candidates[candidate], false) ? IMPOSSIBLE : 0;
+				}
+				else if(propagation.refutes(candidates[candidate], false)) {
+					outcomes[candidate] = 1;
+				}
+			};
+			const int numThreads = candidates.size() < PARALLEL_THRESHOLD
+					? 1
+					: std::max(1u, std::thread::hardware_concurrency());
+			if(numThreads <= 1) {
+				for(size_t candidate = 0; candidate < candidates.size(); candidate++) {
+					test(base, candidate);
+				}
+			}
+			else {
+				std::atomic<size_t> next(0);
+				std::vector<std::thread> workers;
+				for(int worker = 0; worker < numThreads; worker++) {
+					workers.emplace_back([&base, &candidates, &next, &test]() {
+						Propagation propagation = base;
+						for(size_t candidate = next++; candidate < candidates.size(); candidate = next++) {
+							test(propagation, candidate);
+						}
+					});
+				}
+				for(std::thread& worker : workers) {
+					worker.join();
+				}
+			}
+			
+			if(std::find(outcomes.begin(), outcomes.end(), IMPOSSIBLE) != outcomes.end()) {
+				throw std::logic_error("Frontier constraints have no solution: a cell can be neither a mine nor safe");
+			}
+			
+			Deductions result;
+			for(size_t cell = 0; cell < cells.size(); cell++) {
+				if(base.valueOf(cell) == 0) {
+					result.safe.push_back(cells[cell]);
+				}
+				else if(base.valueOf(cell) == 1) {
+					result.mines.push_back(cells[cell]);
+				}
+			}
+			for(size_t candidate = 0; candidate < candidates.size(); candidate++) {
+				if(outcomes[candidate] == 0) {
+					result.safe.push_back(cells[candidates[candidate]]);
+				}
+				else if(outcomes[candidate] == 1) {
+					result.mines.push_back(cells[candidates[candidate]]);
+				}
+			}
+			return result;
+		}
+};
+
+/**
+ * Proves moves with the SAT solver in sat.h (which must be included first): a cell is safe if it
+ * cannot be a mine under the frontier's constraints, and a mine if it cannot be safe. Unlike
+ * enumeration, this stays fast on large connected frontiers.
+ *
+ * One stage is meant to last for one game. Every constraint it is given is a fact about that game's
+ * board, so constraints are encoded once and kept, along with every clause the SAT solver learns
+ * and every cell proven, and later questions are answered faster. As cells are revealed, the
+ * possibility sets which contained them shrink into new constraints, which are encoded in turn.
+ * The search only branches on cells which are still on the frontier: the constraints of cells
+ * which left it are always satisfied by their true values, so they never decide an answer.
+ */
+class Satisfiability final : public Stage {
+	private:
+		// Constraints are encoded directly, as one clause per combination of cells, which stays small for the (at most 8) cells around a number
+		static constexpr size_t MAX_ENCODED_CELLS = 8;
+		
+		// Number of conflicts after which a single question is given up on
+		const std::uint64_t conflictBudget;
+		
+		sat::Solver solver;
+		std::unordered_map<int, int> variables;					//SAT variable of each cell
+		std::set<std::pair<std::vector<int>, int>> encoded;		//constraints which have already been encoded, as sorted cells and mines
+		
+		int variableOf(const int& cell) {
+			auto found = variables.find(cell);
+			if(found == variables.end()) {
+				found = variables.emplace(cell, solver.newVariable()).first;
+			}
+			return found->second;
+		}
+		
+		/**
+		 * Add one clause for every combination of the given size of the given variables: at least one of them is a mine if isMine, or at least one is safe otherwise.
+		 */
+		bool addCombinationClauses(const std::vector<int>& variablesToCombine, const int& size, const bool& isMine) {
+			const int numVariables = variablesToCombine.size();
+			for(unsigned combination = 0; combination < (1u << numVariables); combination++) {
+				if(static_cast<int>(std::bitset<MAX_ENCODED_CELLS>(combination).count()) != size) {
+					continue;
+				}
+				std::vector<sat::Literal> clause;
+				for(int i = 0; i < numVariables; i++) {
+					if(combination & (1u << i)) {
+						clause.push_back(isMine ? sat::positive(variablesToCombine[i]) : sat::negative(variablesToCombine[i]));
+					}
+				}
+				if(!solver.addClause(clause)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		
+		/**
+		 * Encode "exactly this many of these cells are mines": any mines + 1 of the cells include a safe one, and any (cells - mines + 1) of them include a mine.
+		 */
+		void encode(const std::vector<int>& cells, const int& mines) {
+			std::vector<int> cellVariables;
+			for(const int& cell : cells) {
+				cellVariables.push_back(variableOf(cell));
+			}
+			
+			const int numCells = cells.size();
+			if((mines + 1 <= numCells && !addCombinationClauses(cellVariables, mines + 1, false))
+					|| (mines > 0 && !addCombinationClauses(cellVariables, numCells - mines + 1, true))) {
+				throw std::logic_error("Frontier constraints have no solution");
+			}
+		}
+		
+	public:
+		Satisfiability(const std::uint64_t& desiredConflictBudget = 10000
+		) :		conflictBudget(desiredConflictBudget) {}
+		
+		const char* name() const override {
+			return "SAT";
+		}
+		
+		void forget() override {
+			solver = sat::Solver();
+			variables.clear();
+			encoded.clear();
+		}
+		
+		Deductions deduce(const Frontier& frontier) override {
+			std::vector<int> cells;
+			for(const probability::Constraint& constraint : frontier.constraints) {
+				std::vector<int> constraintCells = constraint.cells;
+				std::sort(constraintCells.begin(), constraintCells.end());
+				cells.insert(cells.end(), constraintCells.begin(), constraintCells.end());
+				if(constraintCells.size() <= MAX_ENCODED_CELLS && encoded.emplace(constraintCells, constraint.mines).second) {
+					encode(constraintCells, constraint.mines);
+				}
+			}
+			std::sort(cells.begin(), cells.end());
+			cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+			
+			std::vector<int> decisionVariables;
+			for(const int& cell : cells) {
+				decisionVariables.push_back(variableOf(cell));
+			}
+			
+			// Every satisfying assignment shows a value that each cell can take, so only values which no assignment has shown yet need to be asked about
+			std::vector<char> canBeMine(cells.size(), false);
+			std::vector<char> canBeSafe(cells.size(), false);
+			auto recordModel = [&]() {
+				for(size_t i = 0; i < cells.size(); i++) {
+					(solver.modelValue(decisionVariables[i]) ? canBeMine : canBeSafe)[i] = true;
+				}
+			};
+			
+			const sat::Result initial = solver.solve({}, decisionVariables, conflictBudget);
+			if(initial == sat::UNSATISFIABLE) {
+				throw std::logic_error("Frontier constraints have no solution");
+			}
+			if(initial == sat::UNKNOWN) {
+				return Deductions();
+			}
+			recordModel();
+			
+			Deductions result;
+			for(size_t i = 0; i < cells.size(); i++) {
+				for(const bool& isMine : {true, false}) {
+					if((isMine ? canBeMine : canBeSafe)[i]) {
+						continue;
+					}
+					
+					const sat::Literal assumption = isMine ? sat::positive(decisionVariables[i]) : sat::negative(decisionVariables[i]);
+					const sat::Result answer = solver.solve({assumption}, decisionVariables, conflictBudget);
+					if(answer == sat::SATISFIABLE) {
+						recordModel();
+					}
+					else if(answer == sat::UNSATISFIABLE) {
+						// Keep the proven value, so that later questions (in this call and later ones) start from it
+						solver.addClause({assumption ^ 1});
+						(isMine ? result.safe : result.mines).push_back(cells[i]);
+						break;
+					}
+				}
+			}
+			return result;
+		}
+};
+
+}
\ No newline at end of file
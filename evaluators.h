@@ -4,45 +4,70 @@ namespace field {
 
 namespace evaluators {
 
-bool random(const Minefield& field, const short& row, const short& col) {
+bool random(BoardView& view, const short& row, const short& col) {
 	return true;
 }
 
-bool safeStart(const Minefield& field, const short& row, const short& col) {
-	if(field.getMines() >= field.getRows() * field.getCols()) {
+bool safeStart(BoardView& view, const short& row, const short& col) {
+	if(view.getMines() >= view.getRows() * view.getCols()) {
 		return true;
 	}
 	
-	Minefield prospectiveField = Minefield(field);
-	prospectiveField.revealSpace(row, col);
-	return prospectiveField.getGameStatus() != LOST;
+	return !view.isMine(row, col);
 }
 
-bool safeStartPlus(const Minefield& field, const short& row, const short& col) {
-	int numCells = field.getRows() * field.getCols();
-	int numRevealedCells = 0;
-	
-	Minefield prospectiveField = Minefield(field);
+bool safeStartPlus(BoardView& view, const short& row, const short& col) {
+	int numCells = view.getRows() * view.getCols();
+	int numRegionCells = 0;
+	bool regionHasMine = false;
 	
 	for(short rowModifier = -1; rowModifier <= 1; rowModifier++) {
 		for(short colModifier = -1; colModifier <= 1; colModifier++) {
-			if(prospectiveField.isValidSpace(row + rowModifier, col + colModifier)) {
-				numRevealedCells++;
-				prospectiveField.revealSpace(row + rowModifier, col + colModifier);
+			if(view.isValidSpace(row + rowModifier, col + colModifier)) {
+				numRegionCells++;
+				regionHasMine = regionHasMine || view.isMine(row + rowModifier, col + colModifier);
 			}
 		}
 	}
 	
-	if(prospectiveField.getMines() > numCells - numRevealedCells) {
+	if(view.getMines() > numCells - numRegionCells) {
 		return true;
 	}
 	
-	return prospectiveField.getGameStatus() != LOST;
+	return !regionHasMine;
 }
 
-bool noGuess(const Minefield& field, const short& row, const short& col) {
-	Minefield prospectiveField = Minefield(field);
-	return solver::Solver(prospectiveField).solve();
+bool noGuess(BoardView& view, const short& row, const short& col) {
+	//Generation evaluates many boards of the same size on each thread, so each thread keeps its solver, and resets it for every board instead of building a new one
+	thread_local unique_ptr<solver::Solver> solver;
+	if(solver == nullptr || solver->getRows() != view.getRows() || solver->getCols() != view.getCols()) {
+		solver = make_unique<solver::Solver>(view.play());
+		solver->addStage(make_unique<deduction::Patterns>());
+		solver->addStage(make_unique<deduction::GaussianElimination>());
+		solver->addStage(make_unique<deduction::Hypotheses>());
+		solver->addStage(make_unique<deduction::Satisfiability>());
+	}
+	else {
+		solver->reset(view.play());
+	}
+	
+	//Most candidate boards get the solver stuck at least once, so the solver reports that with a status rather than an exception
+	//The solver checks for cancellation between waves of moves, so that abandoning generation or running over the time budget does not wait for a whole evaluation
+	const function<bool()> isCancelled = [&view]() {
+		return view.isCancelled();
+	};
+	solver::StepStatus status = solver->trySolve(row, col, isCancelled);
+	
+	//Instead of rejecting a board as soon as the solver gets stuck, repair it by moving mines out of the stuck frontier, and resume solving from where it stopped
+	for(int repairs = 0; repairs < view.getMines() && status == solver::STUCK && !view.isCancelled(); repairs++) {
+		if(!solver->relocateFrontierMine(view)) {
+			return false;
+		}
+		status = solver->trySolve(isCancelled);
+	}
+	
+	//A board the solver finds inconsistent is rejected like any other board it cannot finish
+	return status == solver::FINISHED && view.play().getGameStatus() == WON;
 }
 
 }
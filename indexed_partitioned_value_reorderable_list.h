@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * A variant of partitioned_value_reorderable_list for values which already
+ * have a dense index (e.g. cells, which are numbered row * cols + col).
+ *
+ * It has the same interface and the same behavior: iteration in list order,
+ * moving an element by value in constant time, and insertion at the front
+ * of any of a fixed number of partitions. But instead of allocating a list
+ * node and a hash node for every element, every possible element has its
+ * node waiting in one contiguous vector, at the index given by the
+ * caller-provided IndexOf function object. Nodes are linked with 32-bit
+ * indices, so moving an element touches a few neighboring nodes and no
+ * allocator or hash table. Since links are indices, the vector can grow
+ * when an element with a larger index is inserted.
+ *
+ * As in the original, each partition starts with a sentinel node, which
+ * iteration skips. The sentinels come first in the vector, followed by the
+ * node that marks the end of the (circular) list, and then the elements.
+ */
+template <typename T, typename IndexOf>
+class indexed_partitioned_value_reorderable_list {
+	private:
+		static constexpr std::uint32_t UNLINKED = UINT32_MAX;
+		
+		struct Node {
+			T value;
+			std::uint32_t prev = UNLINKED;
+			std::uint32_t next = UNLINKED;
+		};
+		
+		IndexOf indexOf;
+		std::vector<Node> nodes;
+		std::uint32_t endNode;			//index of the node that marks the end of the list, which is also the number of partitions
+		std::size_t count = 0;
+		
+		bool is_sentinel(const std::uint32_t& node) const {
+			return node < endNode;
+		}
+		
+		void unlink(const std::uint32_t node) {
+			nodes[nodes[node].prev].next = nodes[node].next;
+			nodes[nodes[node].next].prev = nodes[node].prev;
+			nodes[node].prev = UNLINKED;
+			nodes[node].next = UNLINKED;
+		}
+		
+		// Links are taken by value, since callers may pass other nodes' links, which change here
+		void link_after(const std::uint32_t node, const std::uint32_t position) {
+			nodes[node].prev = position;
+			nodes[node].next = nodes[position].next;
+			nodes[nodes[position].next].prev = node;
+			nodes[position].next = node;
+		}
+		
+		std::uint32_t partition_sentinel(const std::size_t& partition) const {
+			if(partition >= endNode) {
+				throw std::out_of_range("Partition does not exist");
+			}
+			return partition;
+		}
+		
+		std::uint32_t node_of(const T& value) const {
+			return endNode + 1 + indexOf(value);
+		}
+		
+		bool is_linked(const std::uint32_t& node) const {
+			return node < nodes.size() && nodes[node].prev != UNLINKED;
+		}
+	
+	public:
+		// Standard container type aliases (required for compliance with STL standards for iterating, sorting, etc.)
+		using value_type = T;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T*;
+		using reference = value_type&;
+		using const_reference = const value_type&;
+		
+		// Iterators
+		
+		struct iterator {
+			using value_type = indexed_partitioned_value_reorderable_list::value_type;
+			using reference = indexed_partitioned_value_reorderable_list::reference;
+			using pointer = indexed_partitioned_value_reorderable_list::pointer;
+			using difference_type = indexed_partitioned_value_reorderable_list::difference_type;
+			using iterator_category = std::forward_iterator_tag;
+			
+			indexed_partitioned_value_reorderable_list* container;
+			std::uint32_t node;
+			std::uint32_t stop;			//node at which iteration ends
+			
+			void skip_sentinels() {
+				while(node != stop && container->is_sentinel(node)) {
+					node = container->nodes[node].next;
+				}
+			}
+			
+			// Iterator constructor that initializes to the position of the first real element at or after the given node, or the stop node if there is none before it
+			iterator(	indexed_partitioned_value_reorderable_list* desiredContainer,
+						const std::uint32_t& desiredNode,
+						const std::uint32_t& desiredStop
+			) : container(desiredContainer), node(desiredNode), stop(desiredStop) {
+				skip_sentinels();
+			}
+			
+			reference operator*() const {
+				if(node == stop) {
+					throw std::out_of_range("Cannot dereference end iterator");
+				}
+				
+				return container->nodes[node].value;
+			}
+			
+			pointer operator->() const {
+				return &(operator*());
+			}
+			
+			iterator& operator++() {
+				if(node == stop) {
+					throw std::out_of_range("Cannot increment iterator past end");
+				}
+				
+				node = container->nodes[node].next;
+				skip_sentinels();
+				return *this;
+			}
+			
+			iterator operator++(int) {
+				iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+			
+			friend bool operator==(const iterator& a, const iterator& b) {
+				return a.node == b.node;
+			}
+			friend bool operator!=(const iterator& a, const iterator& b) {
+				return !(a == b);
+			}
+		};
+		
+		iterator begin() {
+			return iterator(this, nodes[endNode].next, endNode);
+		}
+		
+		iterator end() {
+			return iterator(this, endNode, endNode);
+		}
+		
+		/**
+		 * @return an iterator to the first element in the partitions [first_partition, last_partition).
+		 * Iteration stops at the end of partition last_partition - 1, which is reached when the iterator equals partitions_end(last_partition).
+		 */
+		iterator partitions_begin(std::size_t first_partition, std::size_t last_partition) {
+			return iterator(this, partition_sentinel(first_partition), partitions_end(last_partition).node);
+		}
+		
+		iterator partitions_end(std::size_t last_partition) {
+			const std::uint32_t boundary = last_partition < endNode ? partition_sentinel(last_partition) : endNode;
+			return iterator(this, boundary, boundary);
+		}
+		
+		// Constructors
+		
+		/**
+		 * Parameterized constructor that receives a desired number of partitions, the number of values to make room for up front (whose indices are [0, initialCapacity)), and the function object that maps a value to its index.
+		 */
+		indexed_partitioned_value_reorderable_list(	std::size_t numPartitions,
+													std::uint32_t initialCapacity,
+													IndexOf desiredIndexOf
+		) :		indexOf(desiredIndexOf),
+				nodes(numPartitions + 1 + initialCapacity),
+				endNode(numPartitions) {
+			clear();
+		}
+		
+		// Capacity
+		
+		bool empty() const noexcept {
+			return count == 0;
+		}
+		
+		size_type size() const noexcept {
+			return count;
+		}
+		
+		// Modifiers
+		
+		/**
+		 * Erases every element, keeping the nodes for reuse
+		 */
+		void clear() noexcept {
+			for(Node& node : nodes) {
+				node.prev = UNLINKED;
+				node.next = UNLINKED;
+			}
+			nodes[endNode].prev = endNode;
+			nodes[endNode].next = endNode;
+			for(std::uint32_t sentinel = 0; sentinel < endNode; sentinel++) {
+				link_after(sentinel, nodes[endNode].prev);
+			}
+			count = 0;
+		}
+		
+		/**
+		 * Moves an existing element (identified by value) to the front of a partition
+		 */
+		void move_to_partition_front(const T& value, std::size_t partition) {
+			const std::uint32_t node = node_of(value);
+			if(!is_linked(node)) {
+				throw std::out_of_range("Value is not in the list");
+			}
+			
+			const std::uint32_t sentinel = partition_sentinel(partition);
+			if(nodes[sentinel].next == node) {
+				return;
+			}
+			unlink(node);
+			link_after(node, sentinel);
+		}
+		
+		/**
+		 * Inserts a new element to the front of a partition
+		 */
+		void insert_to_partition_front(const T& value, std::size_t partition) {
+			const std::uint32_t node = node_of(value);
+			if(is_linked(node)) {
+				throw std::invalid_argument("Key already exists in the map");
+			}
+			if(node >= nodes.size()) {
+				nodes.resize(std::max<std::size_t>(node + 1, nodes.size() * 2));
+			}
+			
+			nodes[node].value = value;
+			link_after(node, partition_sentinel(partition));
+			count++;
+		}
+		
+		/**
+		 * Erases the element with the given value, if there is one
+		 * @return the number of elements erased (0 or 1).
+		 */
+		size_type erase(const T& value) {
+			const std::uint32_t node = node_of(value);
+			if(!is_linked(node)) {
+				return 0;
+			}
+			
+			unlink(node);
+			count--;
+			return 1;
+		}
+		
+		/**
+		 * Erases the element to which the given iterator points
+		 * @return an iterator to the element following the erased one, or end() if no such element exists.
+		 */
+		iterator erase(const iterator pos) {
+			const std::uint32_t nextNode = nodes[pos.node].next;
+			unlink(pos.node);
+			count--;
+			return iterator(this, nextNode, endNode);
+		}
+};
\ No newline at end of file
@@ -36,6 +36,7 @@ public:
 	// We template this so it handles strings, ints, endl, etc.
 	template <typename T>
 	Logger& operator<<(const T& message) {
+		std::lock_guard<std::mutex> lock(mutex_);
 		if(logFile_.is_open()) {
 			logFile_ << message;
 		}
@@ -44,6 +45,7 @@ public:
 
 	// Special overload for manipulators like std::endl
 	Logger& operator<<(std::ostream& (*manip)(std::ostream&)) {
+		std::lock_guard<std::mutex> lock(mutex_);
 		if(logFile_.is_open()) {
 			manip(logFile_);
 		}
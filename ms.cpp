@@ -1,4 +1,6 @@
 #include "settings.h"
+#include <future>
+#include <memory>
 
 constexpr size_t BORDER = 1;
 constexpr size_t INDENT_SIZE = 3;
@@ -91,12 +93,12 @@ background::background numberColorsBackgrounds[9] = {
 /**
  * Print the given cell to the screen
  */
-void print(Minecell* const cell, const Minefield& minefield, Settings& settings, const bool& losingMove = false) {
+void print(const Minecell& cell, const Minefield& minefield, Settings& settings, const bool& losingMove = false) {
 	FlexibleString output;
 	
-	switch(cell->getState()) {
+	switch(cell.getState()) {
 		case FAIL: //this only means we are not allowed to know the state, i.e. the cell is hidden
-			if(cell->isFlagged()) {
+			if(cell.isFlagged()) {
 				output = color(character::FLAG, text::RED, background::GRAY);
 			}
 			else {
@@ -104,16 +106,16 @@ void print(Minecell* const cell, const Minefield& minefield, Settings& settings,
 			}
 			break;
 		case BLANK:
-			output = color(character::BLANK, cell->isFlagged() ? background::DARK_RED : background::BLACK);
+			output = color(character::BLANK, cell.isFlagged() ? background::DARK_RED : background::BLACK);
 			break;
 		case NUMBER:
 			output = color(
-					to_string(cell->getNumber()),
-					numberColors[cell->getNumber()],
-					cell->isFlagged()
+					to_string(cell.getNumber()),
+					numberColors[cell.getNumber()],
+					cell.isFlagged()
 							? background::DARK_RED
 							: gameFont.dwFontSize.X < settings.getPixelDisplayThreshold()
-									? numberColorsBackgrounds[cell->getNumber()]
+									? numberColorsBackgrounds[cell.getNumber()]
 									: background::BLACK
 			);
 			break;
@@ -121,7 +123,7 @@ void print(Minecell* const cell, const Minefield& minefield, Settings& settings,
 			if(losingMove) {
 				output = color(character::MINE, text::WHITE, background::DARK_RED); //mine that was revealed (causing a loss)
 			}
-			else if(cell->isFlagged()) {
+			else if(cell.isFlagged()) {
 				output = color(character::FLAG, text::RED, background::GRAY); //mine that was correctly flagged
 			}
 			else {
@@ -138,7 +140,7 @@ void print(Minecell* const cell, const Minefield& minefield, Settings& settings,
  */
 template<typename ContainerType>
 void print(ContainerType* const cells, const Minefield& minefield, Settings& settings) {
-	for(Minecell* cell : *cells) {
+	for(const Minecell& cell : *cells) {
 		print(cell, minefield, settings);
 	}
 }
@@ -146,7 +148,7 @@ void print(ContainerType* const cells, const Minefield& minefield, Settings& set
 /**
  * @return true, if the game has ended. false, if the game is still in progress
  */
-bool checkForGameEnd(Minecell* const cell, const Minefield& minefield, Settings& settings) {
+bool checkForGameEnd(const Minecell& cell, const Minefield& minefield, Settings& settings) {
 	if(minefield.getGameStatus() == LOST) {
 		printGameEdgeBorders(text::BLACK, background::RED);
 		window::printInRectangle(color(character::INDICATOR_LOST, text::WHITE, background::RED), COORD{short(windowSize.X / 2), BORDER});
@@ -222,11 +224,25 @@ int main() {
 	//Variable that is used to force opening the main menu once, even if other settings would skip main menu rendering.
 	bool gameNeedsInitializing = true;
 	
+	//Bank of pre-generated boards for the current difficulty and evaluator, mapped once the difficulty is chosen (empty if bankgen has not been run for them)
+	unique_ptr<boardbank::BoardBank> bank;
+	
+	//Next board for the auto-solver, generated on a background thread while the current game is still being played
+	future<unique_ptr<Minefield>> nextMinefield;
+	
+	//Solver for the auto-solver, kept from game to game while the board size stays the same
+	unique_ptr<solver::Solver> solver;
+	
 	//Main application loop - a full game is completed once for each iteration of this loop.
 	//Or, logic might continue to the next iteration early, if reloading the main menu for example.
 	do {
 		// IF auto-solver mode is turned off, OR auto-restarts are turned off, OR app has just been launched, then display the main menu
 		if(settings.getSolverModeDelay() == -1 || settings.getSolverModeGameEndPauseLength() == -1 || gameNeedsInitializing) {
+			//A board prepared in the background may not match the settings about to be chosen, so wait for it and discard it
+			if(nextMinefield.valid()) {
+				nextMinefield.get();
+			}
+			
 			// Start rendering the main menu
 			
 			// Define window sizing parameters
@@ -574,6 +590,13 @@ int main() {
 			
 			window::scaleFontSizeToFit(gameFont, windowSize);
 			
+			bank = make_unique<boardbank::BoardBank>(
+					boardbank::fileName(difficulty.dimensions.Y, difficulty.dimensions.X, difficulty.mines, settings.getEvaluatorName()),
+					difficulty.dimensions.Y,
+					difficulty.dimensions.X,
+					difficulty.mines
+			);
+			
 			gameNeedsInitializing = false;
 		}
 		
@@ -584,16 +607,40 @@ int main() {
 		window::initialize(gameFont, windowSize);
 		printGameEdgeBorders(text::BLACK, background::DARK_GRAY);
 		
-		//Create the minefield
-		Minefield minefield (
-				difficulty.dimensions,
-				difficulty.mines,
-				COORD{short((windowSize.X / 2) - (difficulty.dimensions.X / 2)), 3},
-				settings.getEvaluator()
-		);
+		//Create the minefield, or take over the one prepared in the background during the previous game
+		const COORD minefieldPosition = COORD{short((windowSize.X / 2) - (difficulty.dimensions.X / 2)), 3};
+		const auto fieldEvaluator = settings.getEvaluator();
+		const unsigned generationThreads = settings.getGenerationThreads();
+		unique_ptr<Minefield> currentMinefield = nextMinefield.valid()
+				? nextMinefield.get()
+				: make_unique<Minefield>(difficulty.dimensions, difficulty.mines, minefieldPosition, fieldEvaluator, generationThreads, bank.get());
+		Minefield& minefield = *currentMinefield;
 		
-		//Create a solver
-		solver::Solver solver(minefield);
+		//If the auto-solver will start another game after this one, start generating that game's board now, so that the next game starts instantly
+		if(settings.getSolverModeDelay() > -1 && settings.getSolverModeGameEndPauseLength() > -1) {
+			const Difficulty nextDifficulty = difficulty;
+			boardbank::BoardBank* const nextBank = bank.get();
+			const unsigned seed = randomizer();
+			nextMinefield = async(launch::async, [=]() {
+				unique_ptr<Minefield> preparedMinefield = make_unique<Minefield>(nextDifficulty.dimensions, nextDifficulty.mines, minefieldPosition, fieldEvaluator, generationThreads, nextBank);
+				mt19937 generator(seed);
+				preparedMinefield->prepare(generator);
+				return preparedMinefield;
+			});
+		}
+		
+		//Create a solver, which falls back to local patterns when its own rules find no move, then to Gaussian elimination over the whole frontier, to testing hypotheses about single cells, and to a SAT solver when those find none either
+		//If the previous game was the same size, reset its solver instead
+		if(solver == nullptr || solver->getRows() != minefield.getRows() || solver->getCols() != minefield.getCols()) {
+			solver = make_unique<solver::Solver>(minefield);
+			solver->addStage(make_unique<deduction::Patterns>());
+			solver->addStage(make_unique<deduction::GaussianElimination>());
+			solver->addStage(make_unique<deduction::Hypotheses>());
+			solver->addStage(make_unique<deduction::Satisfiability>());
+		}
+		else {
+			solver->reset(minefield);
+		}
 		
 		//Initialize cursor
 		COORD position = COORD {
@@ -620,8 +667,8 @@ int main() {
 		}
 		
 		//Initialize empty cell containers to hold the results of the user's actions, if any
-		vector<Minecell*> resultVector;
-		unordered_set<Minecell*> resultSet;
+		vector<Minecell> resultVector;
+		unordered_set<Minecell> resultSet;
 		
 		//Flag to ensure end of game is only checked once
 		bool gameEnded = false;
@@ -630,16 +677,25 @@ int main() {
 		short lastKnownTime = -1;
 		ULONGLONG lastAutoSolverStepTime = GetTickCount64();
 		short numIterationsToWaitBetweenGames = settings.getSolverModeGameEndPauseLength();
+		
+		//Generation of the board for the player's first reveal, run in the background so that input and the display keep working while it runs
+		unique_ptr<GenerationControl> generationControl;
+		future<void> firstClickGeneration;
+		COORD firstClickPosition;
 		do {
 			//Display UI timer if it needs updating
-			short currentTime = minefield.getElapsedTime() / 1000;
-			if(currentTime != lastKnownTime) {
-				window::hideCursor();
-				window::printInRectangle(color(getTextFromNumericField(currentTime, 4), text::RED), COORD{short(windowSize.X - 5), 1});
-				lastKnownTime = currentTime;
-				SetConsoleCursorPosition(window::handleOut, position);
-				if(settings.getSolverModeDelay() == -1) {
-					window::showCursor();
+			//While the first-click board is being generated, the minefield belongs to the generating thread, and its progress is displayed in the timer's place instead
+			//A board that ran over its generation time budget only meets the fallback evaluator, which the timer shows by its color
+			if(!firstClickGeneration.valid()) {
+				short currentTime = minefield.getElapsedTime() / 1000;
+				if(currentTime != lastKnownTime) {
+					window::hideCursor();
+					window::printInRectangle(color(getTextFromNumericField(currentTime, 4), minefield.isGeneratedWithFallback() ? text::DARK_YELLOW : text::RED), COORD{short(windowSize.X - 5), 1});
+					lastKnownTime = currentTime;
+					SetConsoleCursorPosition(window::handleOut, position);
+					if(settings.getSolverModeDelay() == -1) {
+						window::showCursor();
+					}
 				}
 			}
 			
@@ -653,6 +709,29 @@ int main() {
 				&cNumRead,			// number of records read
 				0x0002);			// do not wait for input before returning
 			
+			//Check on first-click generation: display its progress, or once the board is ready, make the reveal it was started for
+			if(firstClickGeneration.valid()) {
+				if(firstClickGeneration.wait_for(chrono::milliseconds(0)) != future_status::ready) {
+					window::hideCursor();
+					window::printInRectangle(color(getTextFromNumericField(std::min(generationControl->candidatesEvaluated.load(), 9999), 4), text::YELLOW), COORD{short(windowSize.X - 5), 1});
+					SetConsoleCursorPosition(window::handleOut, position);
+				}
+				else if(cNumRead == 0) {
+					firstClickGeneration.get();
+					lastKnownTime = -1; //redraw the timer over the progress display
+					position = firstClickPosition;
+					cNumRead = 1;
+					
+					KEY_EVENT_RECORD dummyKeyEvent;
+					dummyKeyEvent.bKeyDown = true;
+					dummyKeyEvent.wVirtualKeyCode = VK_RETURN;
+					INPUT_RECORD dummyRecord;
+					dummyRecord.EventType = KEY_EVENT;
+					dummyRecord.Event.KeyEvent = dummyKeyEvent;
+					inputBuffer[0] = dummyRecord;
+				}
+			}
+			
 			//Check if auto-solver should perform a step
 			if(cNumRead == 0
 					&& settings.getSolverModeDelay() > -1
@@ -691,13 +770,20 @@ int main() {
 					resultVector.clear();
 				}
 				
-				Minecell* resultingCell;
+				Minecell resultingCell;
 				
 				//Handle input
 				if(keyEvent.wVirtualKeyCode == VK_ESCAPE) {
+					if(firstClickGeneration.valid()) {
+						generationControl->cancelled = true;
+						firstClickGeneration.get();
+					}
 					gameNeedsInitializing = true;
 					exit = true;
 				}
+				else if(firstClickGeneration.valid()) {
+					continue; //the board is still being generated, so nothing else can be done with it yet
+				}
 				else if(settings.getSolverModeDelay() == -1) {
 					switch(keyEvent.wVirtualKeyCode) {
 						case VK_UP:
@@ -729,6 +815,28 @@ int main() {
 									position.X++;
 							break;
 						case VK_RETURN:
+							//Generating the board for the first reveal can take a while, so do it in the background and reveal once the board is ready
+							if(minefield.getGameStatus() == UNSTARTED && minefield.getPreparedStart() != minefield.at(position)) {
+								const Minecell firstCell = minefield.at(position);
+								const short row = firstCell.getRow();
+								const short col = firstCell.getCol();
+								const unsigned seed = randomizer();
+								
+								generationControl = make_unique<GenerationControl>();
+								if(settings.getGenerationTimeBudget() > -1) {
+									generationControl->deadline = GetTickCount64() + settings.getGenerationTimeBudget();
+									generationControl->fallbackEvaluator = settings.getFallbackEvaluator();
+								}
+								GenerationControl* const control = generationControl.get();
+								
+								firstClickPosition = position;
+								firstClickGeneration = async(launch::async, [&minefield, row, col, seed, control]() {
+									mt19937 generator(seed);
+									minefield.prepare(row, col, generator, control);
+								});
+								continue; //the minefield belongs to the generating thread until the board is ready, so there is nothing to print or check yet
+							}
+							
 							settings.getContainerType() == "fragmented"
 									? resultingCell = minefield.revealSpace(position, &resultSet)
 									: resultingCell = minefield.revealSpace(position, &resultVector);
@@ -757,9 +865,16 @@ int main() {
 					}
 				}
 				else {
-					settings.getContainerType() == "fragmented"
-							? resultingCell = solver.step(&resultSet)
-							: resultingCell = solver.step(&resultVector);
+					try {
+						settings.getContainerType() == "fragmented"
+								? resultingCell = solver->step(&resultSet)
+								: resultingCell = solver->step(&resultVector);
+					} catch(solver::NoValidMoveException e) {
+						//No move can be deduced, so reveal the cell least likely to be a mine
+						settings.getContainerType() == "fragmented"
+								? resultingCell = solver->guess(&resultSet)
+								: resultingCell = solver->guess(&resultVector);
+					}
 					
 					//Display mine count
 					window::printInRectangle(color(getTextFromNumericField(minefield.getMineCount(), 4), text::RED), COORD{1, 1});
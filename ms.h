@@ -1,4 +1,7 @@
+#include "bitboard.h"
+#include "boardbank.h"
 #include "window.h"
+#include <atomic>
 
 namespace field {
 
@@ -22,120 +25,62 @@ class Cell {
 		const short col;
 };
 
-class Minecell final : public Cell {
+class Minefield;
+
+/**
+ * Lightweight handle to a single cell of a Minefield.
+ * The cell's data lives in the minefield's packed arrays; the handle only records which field and which index it refers to.
+ */
+class Minecell final {
 	friend class Minefield;
 	private:
-		bool hidden = true;
-		bool flagged = false;
-		State state;
-		short number;
-	
-		Minecell(	const short& desiredRow,
-					const short& desiredCol
-		) :		Cell(desiredRow, desiredCol),
-				state(UNINITIALIZED) {}
+		const Minefield* field;
+		int index;
 		
+		Minecell(	const Minefield* desiredField,
+					const int& desiredIndex
+		) :		field(desiredField),
+				index(desiredIndex) {}
+	
+	public:
 		/**
-		 * Attempt to initialize the cell
-		 * Returns whether attempt was successful
+		 * Default Constructor, creates a handle which does not refer to any cell
 		 */
-		const bool init(const State& desiredState, const short& desiredNumber = 0) {
-			if(state != UNINITIALIZED) {
-				return false;
-			}
-			else switch(desiredState) {
-				case MINE:
-					state = MINE;
-					return true;
-				case NUMBER:
-					if(desiredNumber == 0) {
-						state = BLANK;
-					}
-					else {
-						state = NUMBER;
-						number = desiredNumber;
-					}
-					return true;
-				default:
-					return false;
-			}
-		}
+		Minecell() : field(nullptr), index(-1) {}
 		
 		/**
-		 * Attempt to flag the cell
-		 * @return the number of flags placed by this action:
-		 *	-1		a flag was removed
-		 *	 0		no flag was placed or removed
-		 *	 1		a flag was placed
+		 * @return the position of the cell in its field's arrays (row * cols + col).
 		 */
-		const short toggleFlag() {
-			if(flagged) {
-				flagged = false;
-				return -1;
-			}
-			
-			if(hidden) {
-				flagged = true;
-				return 1;
-			}
-			
-			return 0;
+		const int getIndex() const {
+			return index;
 		}
 		
-		/**
-		 * Attempt to reveal the cell
-		 * @return the state, if it was newly revealed. Else, return FAIL State to indicate that no reveal was performed.
-		 */
-		const State reveal() {
-			if(state == UNINITIALIZED) {
-				throw logic_error("Cell must be initialized before call to reveal()");
-			}
-			
-			if(hidden && !flagged) {
-				hidden = false;
-				return state;
-			}
-			else {
-				return FAIL;
-			}
-		}
-	
-	public:
-		/**
-		 * Attempt to get the cell's state
-		 * @return the state, if it is public knowledge. Else, return FAIL State to indicate that the requested information is not available.
-		 */
-		const State getState() const {
-			if(!hidden) {
-				return state;
-			}
-			else {
-				return FAIL;
-			}
-		}
+		const short getRow() const;
+		const short getCol() const;
+		const State getState() const;
+		const short getNumber() const;
+		const bool isFlagged() const;
 		
-		/**
-		 * Attempt to get the cell's number
-		 * @return the number, if it is public knowledge. Else, return 0 to indicate that the requested information is not available.
-		 */
-		const short getNumber() const {
-			if(!hidden && state == NUMBER) {
-				return number;
-			}
-			else {
-				return 0;
-			}
+		bool operator==(const Minecell& other) const {
+			return field == other.field && index == other.index;
 		}
 		
-		/**
-		 * Whether the cell is flagged or not
-		 * @return true if the cell is flagged.
-		 */
-		const bool isFlagged() const {
-			return flagged;
+		bool operator!=(const Minecell& other) const {
+			return !(*this == other);
 		}
 };
 
+}
+
+template<>
+struct std::hash<field::Minecell> {
+	size_t operator()(const field::Minecell& cell) const noexcept {
+		return std::hash<int>()(cell.getIndex());
+	}
+};
+
+namespace field {
+
 enum GameStatus {
 	UNSTARTED,
 	PLAYING,
@@ -143,35 +88,46 @@ enum GameStatus {
 	LOST
 };
 
+//Row and column offsets from a cell to each of its (up to 8) adjacent cells
+constexpr short ADJACENT_OFFSETS[8][2] = {
+	{-1, -1}, {-1, 0}, {-1, 1},
+	{ 0, -1},          { 0, 1},
+	{ 1, -1}, { 1, 0}, { 1, 1}
+};
+
+/**
+ * Fixed-size list of the indices of the cells adjacent to a cell.
+ * Returned by value from Field::getNeighbors so that iterating neighbors never allocates.
+ */
+struct Neighbors {
+	int indices[8];
+	unsigned char count = 0;
+	
+	const int* begin() const {
+		return indices;
+	}
+	
+	const int* end() const {
+		return indices + count;
+	}
+	
+	const unsigned char size() const {
+		return count;
+	}
+};
+
 class Field {
 	protected:
 		const short rows;					//number of rows
 		const short cols;					//number of columns
-		vector<vector<Cell*>> cells;		//holds pointers to all cells
-		
-		unordered_set<Cell*> getAdjacentCells(Cell* cell) const {
-			unordered_set<Cell*> result;
-			for(short rowModifier = -1; rowModifier <= 1; rowModifier++) {
-				for(short colModifier = -1; colModifier <= 1; colModifier++) {
-					const short row = cell->row + rowModifier;
-					const short col = cell->col + colModifier;
-					if(!(row == cell->row && col == cell->col)	//coordinates are not the same as the original space
-						&& isValidSpace(row, col)) {			//coordinates requested are within field bounds
-						result.insert(at(row, col));
-					}
-				}
-			}
-			return result;
-		}
+		int adjacentIndexOffsets[8];		//ADJACENT_OFFSETS converted to index offsets for this field's width
 		
-		unordered_set<Cell*> getAllCells() const {
-			unordered_set<Cell*> result;
-			for(const vector<Cell*>& row : cells) {
-				for(Cell* cell : row) {
-					result.insert(cell);
-				}
-			}
-			return result;
+		/**
+		 * @return whether the cell at the given coordinates has all 8 neighbors inside the field, so that its neighbors can be reached without bounds checks.
+		 */
+		const bool isInteriorSpace(const short& row, const short& col) const {
+			return row > 0 && row < rows - 1
+				&& col > 0 && col < cols - 1;
 		}
 	
 	public:
@@ -179,13 +135,10 @@ class Field {
 		 * Default Constructor
 		 */
 		Field(const short& desiredRows, const short& desiredCols)
-				: rows(desiredRows), cols(desiredCols) {}
-		
-		/**
-		 * @return pointer to the cell at the given coordinates.
-		 */
-		Cell* at(const short& row, const short& col) const {
-			return cells.at(row).at(col);
+				: rows(desiredRows), cols(desiredCols) {
+			for(short offset = 0; offset < 8; offset++) {
+				adjacentIndexOffsets[offset] = ADJACENT_OFFSETS[offset][0] * cols + ADJACENT_OFFSETS[offset][1];
+			}
 		}
 		
 		/**
@@ -210,26 +163,76 @@ class Field {
 				&& col >= 0 && col < cols;
 		}
 		
-		virtual ~Field() {
-			for(vector<Cell*>& row : cells) {
-				for(Cell* cell_ptr : row) {
-					delete cell_ptr;
+		/**
+		 * @return the index of the given coordinates in the field's row-major cell order.
+		 */
+		const int indexOf(const short& row, const short& col) const {
+			return row * cols + col;
+		}
+		
+		/**
+		 * @return the row of the cell at the given index.
+		 */
+		const short rowOf(const int& index) const {
+			return index / cols;
+		}
+		
+		/**
+		 * @return the column of the cell at the given index.
+		 */
+		const short colOf(const int& index) const {
+			return index % cols;
+		}
+		
+		/**
+		 * Call the given visitor with the index of every cell adjacent to the cell at the given index.
+		 * Interior cells use the precomputed index offsets directly; only cells on the edge of the field need bounds checks.
+		 */
+		template<typename Visitor>
+		void forEachNeighbor(const int& index, Visitor&& visit) const {
+			const short cellRow = rowOf(index);
+			const short cellCol = colOf(index);
+			if(isInteriorSpace(cellRow, cellCol)) {
+				for(const int& offset : adjacentIndexOffsets) {
+					visit(index + offset);
+				}
+			}
+			else {
+				for(const auto& offset : ADJACENT_OFFSETS) {
+					const short row = cellRow + offset[0];
+					const short col = cellCol + offset[1];
+					if(isValidSpace(row, col)) {
+						visit(indexOf(row, col));
+					}
 				}
 			}
-			cells.clear();
 		}
+		
+		/**
+		 * @return the indices of all cells adjacent to the cell at the given index.
+		 */
+		Neighbors getNeighbors(const int& index) const {
+			Neighbors result;
+			forEachNeighbor(index, [&result](const int& neighbor) {
+				result.indices[result.count++] = neighbor;
+			});
+			return result;
+		}
+		
+		virtual ~Field() {}
 };
 
 class Minefield;
+class BoardView;
 
 namespace evaluators {
 
-bool random(const Minefield& field, const short& row, const short& col);
-bool safeStart(const Minefield& field, const short& row, const short& col);
-bool safeStartPlus(const Minefield& field, const short& row, const short& col);
-bool noGuess(const Minefield& field, const short& row, const short& col);
+bool random(BoardView& view, const short& row, const short& col);
+bool safeStart(BoardView& view, const short& row, const short& col);
+bool safeStartPlus(BoardView& view, const short& row, const short& col);
+bool noGuess(BoardView& view, const short& row, const short& col);
 
-unordered_map<string, const function<bool(const Minefield& field, const short& row, const short& col)>> evaluator = {
+unordered_map<string, const function<bool(BoardView& view, const short& row, const short& col)>> evaluator = {
 	{"random", random},
 	{"safeStart", safeStart},
 	{"safeStartPlus", safeStartPlus},
@@ -238,118 +241,420 @@ unordered_map<string, const function<bool(const Minefield& field, const short& r
 
 }
 
+/**
+ * Controls for generating a board on a background thread (see Minefield::prepare): progress reporting, cancellation, and a time budget.
+ */
+struct GenerationControl {
+	atomic<bool> cancelled{false};			//raised by the caller to abandon generation
+	atomic<int> candidatesEvaluated{0};		//number of candidate boards evaluated so far
+	ULONGLONG deadline = ULLONG_MAX;		//tick count after which candidates are evaluated by the fallback evaluator instead
+	const function<bool(BoardView& view, const short& row, const short& col)>* fallbackEvaluator = nullptr;
+											//cheaper evaluator to fall back to once the deadline has passed, or nullptr to never fall back
+	atomic<bool> usedFallback{false};		//whether the deadline passed and the fallback evaluator was used
+};
+
 class Minefield final : public Field {
+	friend class Minecell;
+	friend class BoardView;
 	private:
 		//set at construction
 		const int mines;					//number of mines
 		const COORD positionOffset;			//position of the board's top-left corner in the screen coordinate system
-		const function<bool(const Minefield& field, const short& row, const short& col)>* const evaluate;
+		const function<bool(BoardView& view, const short& row, const short& col)>* const evaluate;
 											//arbitrary function that determines if a field is valid to play, based on the state at initialization
+		const unsigned generationThreads;	//number of threads generating candidate boards at once, after the first candidate is rejected
+		const boardbank::BoardBank* const bank;
+											//pre-generated boards to pick from before generating one, or nullptr
+		
+		//cell data, stored as parallel arrays indexed by row * cols + col
+		vector<unsigned char> states;		//State of each cell
+		vector<unsigned char> hidden;		//whether each cell is still hidden
+		vector<unsigned char> flagged;		//whether each cell is flagged
+		vector<unsigned char> numbers;		//number of adjacent mines, for NUMBER cells
+		const int wordsPerRow;				//number of 64-bit words per row in the mine layer
+		vector<uint64_t> mineBits;			//mine layer: one bit per cell, each row padded to a whole number of words
+		vector<uint64_t> neighborScratch;	//scratch rows for the neighbor counting kernel, one block of bitboard::SCRATCH_ROWS rows per row band
+		vector<bool> floodVisited;			//scratch bitmap marking cells already examined by the current blank region reveal
+		
+		int preparedStart = -1;				//cell which the board was generated for ahead of the first reveal by prepare(), or -1
+		GenerationControl* generationControl = nullptr;
+											//controls for the generation in progress, if prepare() was given any
+		bool generatedWithFallback = false;	//whether the time budget ran out during generation, so the board only meets the fallback evaluator
+		
+		//speculative play by evaluators (see BoardView)
+		bool speculating = false;			//whether reveals and flags are currently being journaled
+		vector<int> speculationJournal;		//indices of cells revealed or flagged while speculating
+		const atomic<bool>* generationCancelled = nullptr;
+											//for candidate boards generated in parallel: raised once any candidate has been accepted
 		
 		//updated thoughout the game
-		GameStatus gameStatus = UNSTARTED;	//current status of the game
+		atomic<GameStatus> gameStatus{UNSTARTED};
+											//current status of the game. Atomic, since prepare() plays the board speculatively on a background thread while the UI reads the status
 		int remainingSpaces;				//number of safe spaces (not mines) that remain hidden
 		int mineCount;						//number of mines minus the number of placed flags
 		ULONGLONG startTime;				//system time when the game was started
 		ULONGLONG endTime;					//system time when the game was completed
 		
 		/**
-		 * Reset the field by reinitializing the cells vector with newly created cells (uninitialized state)
+		 * Reset the field for another generation attempt by returning all cells to the uninitialized state, in place.
+		 * Cell storage is allocated once at construction, so retries perform no allocations.
+		 * Only the layers written during generation are cleared: numbers are fully rewritten by generateNumbers,
+		 * and hidden/flagged markers cannot change before the first reveal.
 		 */
 		void resetBoard() {
-			cells = vector<vector<Cell*>>();
-			for(short row = 0; row < rows; row++) {
-				cells.push_back(vector<Cell*>());
-				for(short col = 0; col < cols; col++) {
-					cells.at(row).push_back(new Minecell(row, col));
-				}
+			fill(states.begin(), states.end(), UNINITIALIZED);
+			fill(mineBits.begin(), mineBits.end(), 0);
+		}
+		
+		/**
+		 * @return whether the cell at the given index holds a mine, according to the mine layer.
+		 */
+		const bool hasMine(const int& index) const {
+			return (mineBits[rowOf(index) * wordsPerRow + colOf(index) / 64] >> (colOf(index) % 64)) & 1;
+		}
+		
+		/**
+		 * Place or remove a mine at the given index, keeping the cell state and the mine layer in agreement.
+		 */
+		void setMine(const int& index, const bool& isMine) {
+			uint64_t& word = mineBits[rowOf(index) * wordsPerRow + colOf(index) / 64];
+			const uint64_t mask = uint64_t(1) << (colOf(index) % 64);
+			if(isMine) {
+				states[index] = MINE;
+				word |= mask;
+			}
+			else {
+				states[index] = UNINITIALIZED;
+				word &= ~mask;
 			}
 		}
 		
-		unordered_set<Minecell*> getAdjacentCells(Minecell* cell) const {
-			unordered_set<Minecell*> result;
-			for(auto& baseCell : Field::getAdjacentCells(cell)) {
-				result.insert(static_cast<Minecell*>(baseCell));
+		/**
+		 * Attempt to initialize the cell at the given index
+		 * Returns whether attempt was successful
+		 */
+		const bool initCell(const int& index, const State& desiredState, const short& desiredNumber = 0) {
+			if(states[index] != UNINITIALIZED) {
+				return false;
+			}
+			else switch(desiredState) {
+				case MINE:
+					states[index] = MINE;
+					return true;
+				case NUMBER:
+					if(desiredNumber == 0) {
+						states[index] = BLANK;
+					}
+					else {
+						states[index] = NUMBER;
+						numbers[index] = desiredNumber;
+					}
+					return true;
+				default:
+					return false;
+			}
+		}
+		
+		/**
+		 * Record that the cell at the given index is about to be revealed or flagged, so that a speculative play-out can be rolled back.
+		 */
+		void journal(const int& index) {
+			if(speculating) {
+				speculationJournal.push_back(index);
 			}
-			return result;
 		}
 		
-		unordered_set<Minecell*> getAllCells() const {
-			unordered_set<Minecell*> result;
-			for(auto& baseCell : Field::getAllCells()) {
-				result.insert(static_cast<Minecell*>(baseCell));
+		/**
+		 * Attempt to flag the cell at the given index
+		 * @return the number of flags placed by this action:
+		 *	-1		a flag was removed
+		 *	 0		no flag was placed or removed
+		 *	 1		a flag was placed
+		 */
+		const short toggleFlag(const int& index) {
+			if(flagged[index]) {
+				journal(index);
+				flagged[index] = false;
+				return -1;
+			}
+			
+			if(hidden[index]) {
+				journal(index);
+				flagged[index] = true;
+				return 1;
+			}
+			
+			return 0;
+		}
+		
+		/**
+		 * Attempt to reveal the cell at the given index
+		 * @return the state, if it was newly revealed. Else, return FAIL State to indicate that no reveal was performed.
+		 */
+		const State reveal(const int& index) {
+			if(states[index] == UNINITIALIZED) {
+				throw logic_error("Cell must be initialized before call to reveal()");
+			}
+			
+			if(hidden[index] && !flagged[index]) {
+				journal(index);
+				hidden[index] = false;
+				return State(states[index]);
+			}
+			else {
+				return FAIL;
 			}
-			return result;
 		}
 		
 		/**
-		 * Initialize the field by placing mines and generating all blank and number spaces
+		 * Determine which cells must stay free of mines so that the evaluator's requirements for the first move can be met.
+		 * Evaluators are only looked up here, once per game, rather than for every candidate mine.
 		 * @param row is the row of the cell about to be revealed.
 		 * @param col is the column of the cell about to be revealed.
-		 * @return a pointer to the cell about to be revealed.
+		 * @return the indices of the protected cells, in ascending order.
 		 */
-		Minecell* init(const short row, const short col) {
-			int numCells = rows * cols;
-			//Construct a distribution which, when given a randomizer, can produce a number that refers to a unique cell in the field space
-			uniform_int_distribution<> generateNumberInRangeUsing(0, numCells - 1);
+		vector<int> getProtectedCells(const short& row, const short& col) const {
+			const int numCells = rows * cols;
+			vector<int> protectedCells;
 			
-			gameStatus = PLAYING;
+			if(evaluate == &field::evaluators::evaluator["random"]) {
+				return protectedCells;
+			}
 			
-			do {
-				resetBoard();
-				
-				//Generate mines
-				for(int numberOfMinesPlaced = 0; numberOfMinesPlaced < mines; ) {
-					int index = generateNumberInRangeUsing(randomizer);
-					short candidateRow = index / cols;
-					short candidateCol = index % cols;
-					
-					//Optimizations for some evaluators
-					if(evaluate != &field::evaluators::evaluator["random"]) {
-						if(mines < numCells
-								&& candidateRow == row
-								&& candidateCol == col) {
-							continue;
-						}
-						
-						if(evaluate == &field::evaluators::evaluator["safeStartPlus"]
-								|| evaluate == &field::evaluators::evaluator["noGuess"]) {
-							short numRevealedCells = 0;
-							for(short rowModifier = -1; rowModifier <= 1; rowModifier++) {
-								for(short colModifier = -1; colModifier <= 1; colModifier++) {
-									if(isValidSpace(row + rowModifier, col + colModifier)) {
-										numRevealedCells++;
-									}
-								}
-							}
-							
-							if(mines <= numCells - numRevealedCells
-									&& candidateRow >= row - 1 && candidateRow <= row + 1
-									&& candidateCol >= col - 1 && candidateCol <= col + 1) {
-								continue;
-							}
+			if(evaluate == &field::evaluators::evaluator["safeStartPlus"]
+					|| evaluate == &field::evaluators::evaluator["noGuess"]) {
+				for(short rowModifier = -1; rowModifier <= 1; rowModifier++) {
+					for(short colModifier = -1; colModifier <= 1; colModifier++) {
+						if(isValidSpace(row + rowModifier, col + colModifier)) {
+							protectedCells.push_back(indexOf(row + rowModifier, col + colModifier));
 						}
 					}
-					
-					Minecell* candidate = at(candidateRow, candidateCol);
-					if(candidate->init(MINE)) {
-						numberOfMinesPlaced++;
+				}
+				
+				if(mines <= numCells - int(protectedCells.size())) {
+					return protectedCells;
+				}
+				protectedCells.clear();
+			}
+			
+			if(mines < numCells) {
+				protectedCells.push_back(indexOf(row, col));
+			}
+			return protectedCells;
+		}
+		
+		/**
+		 * Place all mines on a freshly reset board, choosing uniformly among the cells which are not protected.
+		 * Uses Floyd's sampling algorithm so that exactly one random draw is made per mine, with no retries on collisions.
+		 * When more than half of the allowed cells are mines, the safe cells are sampled instead.
+		 * @param protectedCells holds the indices of cells which must not receive a mine, in ascending order.
+		 */
+		void placeMines(const vector<int>& protectedCells, mt19937& generator) {
+			const int numAllowedCells = rows * cols - protectedCells.size();
+			
+			//Convert a rank among the allowed cells into the index of that cell, by skipping over the protected cells
+			auto allowedCell = [&protectedCells](int rank) {
+				for(const int& protectedCell : protectedCells) {
+					if(protectedCell > rank) {
+						break;
 					}
+					rank++;
+				}
+				return rank;
+			};
+			
+			const bool sampleSafeCells = mines > numAllowedCells / 2;
+			const int numSamples = sampleSafeCells ? numAllowedCells - mines : mines;
+			const State sampledState = sampleSafeCells ? UNINITIALIZED : MINE;
+			
+			if(sampleSafeCells) {
+				for(int rank = 0; rank < numAllowedCells; rank++) {
+					setMine(allowedCell(rank), true);
+				}
+			}
+			
+			//Floyd's algorithm: for each j in the last numSamples ranks, draw from [0, j] and fall back to j itself if the draw was already taken
+			for(int j = numAllowedCells - numSamples; j < numAllowedCells; j++) {
+				int candidate = allowedCell(uniform_int_distribution<>(0, j)(generator));
+				if(states[candidate] == sampledState) {
+					candidate = allowedCell(j);
 				}
+				setMine(candidate, sampledState == MINE);
+			}
+		}
+		
+		/**
+		 * Move a mine to a cell which has none, on an already generated board.
+		 * Only the numbers and states of the cells around the two positions are recomputed.
+		 */
+		void relocateMine(const int& from, const int& to) {
+			setMine(from, false);
+			setMine(to, true);
+			
+			auto recount = [this](const int& index) {
+				unsigned char count = 0;
+				forEachNeighbor(index, [&](const int& neighbor) {
+					count += hasMine(neighbor);
+				});
+				numbers[index] = count;
 				
-				//Generate adjacent numbers
-				for(Minecell* cell : getAllCells()) {
-					short sumOfNeighboringMines = 0;
-					unordered_set<Minecell*> neighbors = getAdjacentCells(cell);
-					for(Minecell* neighbor : neighbors) {
-						if(neighbor->state == MINE) {
-							sumOfNeighboringMines++;
+				if(!hasMine(index)) {
+					states[index] = count == 0 ? BLANK : NUMBER;
+				}
+			};
+			
+			recount(from);
+			forEachNeighbor(from, recount);
+			forEachNeighbor(to, recount);
+		}
+		
+		/**
+		 * Initialize every cell that is not a mine as a BLANK or NUMBER cell, from the mine layer.
+		 * Neighbor counts are computed for whole rows at a time by the bitboard kernel, split into row bands across threads on huge boards.
+		 */
+		void generateNumbers() {
+			bitboard::forEachRowBand(rows, cols, [this](const int& band, const int& firstRow, const int& lastRow) {
+				uint64_t* const scratch = neighborScratch.data() + band * bitboard::SCRATCH_ROWS * wordsPerRow;
+				bitboard::countNeighbors(mineBits.data(), rows, cols, wordsPerRow, firstRow, lastRow, numbers.data(), scratch);
+				for(int index = firstRow * cols; index < lastRow * cols; index++) {
+					initCell(index, NUMBER, numbers[index]);
+				}
+			});
+		}
+		
+		/**
+		 * Generate one candidate board: place mines using the given random generator, then generate adjacent numbers.
+		 */
+		void generateCandidate(const vector<int>& protectedCells, mt19937& generator) {
+			resetBoard();
+			placeMines(protectedCells, generator);
+			generateNumbers();
+		}
+		
+		bool evaluateBoard(const short& row, const short& col, mt19937& generator);
+		
+		const bool isGenerationAbandoned() const {
+			return generationControl != nullptr && generationControl->cancelled.load();
+		}
+		
+		const bool isGenerationOverBudget() const {
+			return generationControl != nullptr && generationControl->fallbackEvaluator != nullptr && GetTickCount64() > generationControl->deadline;
+		}
+		
+		/**
+		 * Generate and evaluate candidate boards on several threads at once, each with its own board and random stream, until one is accepted.
+		 * The remaining workers are cancelled, and this field adopts the accepted board's layout.
+		 * @return whether a board was accepted, i.e. false if generation was abandoned.
+		 */
+		bool generateInParallel(const vector<int>& protectedCells, const short& row, const short& col, mt19937& generator) {
+			atomic<bool> boardAccepted(false);
+			unsigned winner = 0;
+			
+			vector<Minefield> candidates(generationThreads, *this);
+			vector<thread> workers;
+			for(unsigned worker = 0; worker < generationThreads; worker++) {
+				candidates[worker].generationCancelled = &boardAccepted;
+				candidates[worker].generationControl = generationControl;
+				workers.emplace_back([&, worker, seed = generator()]() {
+					mt19937 workerRandomizer(seed);
+					Minefield& candidate = candidates[worker];
+					
+					while(!boardAccepted.load() && !isGenerationAbandoned()) {
+						candidate.generateCandidate(protectedCells, workerRandomizer);
+						if(candidate.evaluateBoard(row, col, workerRandomizer) && !boardAccepted.exchange(true)) {
+							winner = worker;
 						}
 					}
-					
-					cell->init(NUMBER, sumOfNeighboringMines);
+				});
+			}
+			for(thread& worker : workers) {
+				worker.join();
+			}
+			
+			if(!boardAccepted.load()) {
+				return false;
+			}
+			
+			states.swap(candidates[winner].states);
+			numbers.swap(candidates[winner].numbers);
+			mineBits.swap(candidates[winner].mineBits);
+			return true;
+		}
+		
+		/**
+		 * Try to take a pre-generated board from the bank, under a symmetry which puts the given cell in the board's opening.
+		 * Boards are drawn at random, and each is tried under all of its symmetries.
+		 * Bank boards were accepted by the evaluator when they were generated, so they are not evaluated again.
+		 * @return whether a board was taken from the bank.
+		 */
+		bool loadFromBank(const short& row, const short& col, mt19937& generator) {
+			if(bank == nullptr || bank->size() == 0) {
+				return false;
+			}
+			
+			for(int attempt = 0; attempt < 64; attempt++) {
+				const uint64_t board = uniform_int_distribution<uint64_t>(0, bank->size() - 1)(generator);
+				for(int symmetry = 0; symmetry < bank->symmetries(); symmetry++) {
+					if(bank->isInOpening(board, symmetry, row, col)) {
+						resetBoard();
+						for(int index = 0; index < rows * cols; index++) {
+							if(bank->hasMine(board, symmetry, rowOf(index), colOf(index))) {
+								setMine(index, true);
+							}
+						}
+						generateNumbers();
+						return true;
+					}
+				}
+			}
+			
+			return false;
+		}
+		
+		/**
+		 * Generate candidate boards until the evaluator accepts one.
+		 * @param row is the row of the cell about to be revealed.
+		 * @param col is the column of the cell about to be revealed.
+		 * @param generator is the random generator to draw from. It must not be shared with any other thread.
+		 * @return whether a board was accepted, i.e. false if generation was abandoned.
+		 */
+		bool generate(const short& row, const short& col, mt19937& generator) {
+			const vector<int> protectedCells = getProtectedCells(row, col);
+			
+			//Most evaluators accept nearly every board, so the first candidate is always tried on this thread alone
+			generateCandidate(protectedCells, generator);
+			if(evaluateBoard(row, col, generator)) {
+				return true;
+			}
+			
+			if(generationThreads > 1) {
+				return generateInParallel(protectedCells, row, col, generator);
+			}
+			
+			do {
+				if(isGenerationAbandoned()) {
+					return false;
 				}
-			} while(!(*evaluate)(*this, row, col));
+				generateCandidate(protectedCells, generator);
+			} while(!evaluateBoard(row, col, generator));
+			return true;
+		}
+		
+		/**
+		 * Initialize the field by placing mines and generating all blank and number spaces, unless the board was already prepared for this cell
+		 * If generation is abandoned, the game is left unstarted.
+		 * @param row is the row of the cell about to be revealed.
+		 * @param col is the column of the cell about to be revealed.
+		 * @param generator is the random generator to draw from. It must not be shared with any other thread.
+		 * @return the cell about to be revealed.
+		 */
+		Minecell init(const short row, const short col, mt19937& generator) {
+			gameStatus = PLAYING;
+			
+			if(indexOf(row, col) != preparedStart && !loadFromBank(row, col, generator) && !generate(row, col, generator)) {
+				gameStatus = UNSTARTED;
+			}
+			preparedStart = -1;
 			
 			startTime = GetTickCount64(); //reset timer to eliminate delay from board generation and validation
 			return at(row, col);
@@ -360,16 +665,18 @@ class Minefield final : public Field {
 			col = screenPosition.X - positionOffset.X;
 		}
 		
-		template<typename ContainerType = unordered_set<Minecell*>>
+		template<typename ContainerType = unordered_set<Minecell>>
 		void lose(ContainerType* const result = nullptr) {
 			gameStatus = LOST;
 			endTime = GetTickCount64();
 			
 			if(result != nullptr) {
-				for(Minecell* cell : getAllCells()) {
-					if(cell->state == MINE || (cell->hidden && cell->flagged)) {
-						cell->hidden = false;
-						result->insert(result->end(), cell);
+				const int numCells = rows * cols;
+				for(int index = 0; index < numCells; index++) {
+					if(states[index] == MINE || (hidden[index] && flagged[index])) {
+						journal(index);
+						hidden[index] = false;
+						result->insert(result->end(), Minecell(this, index));
 					}
 				}
 			}
@@ -379,22 +686,80 @@ class Minefield final : public Field {
 			gameStatus = WON;
 			endTime = GetTickCount64();
 		}
+		
+		/**
+		 * Reveal every cell connected to the given newly revealed BLANK cell, using an explicit work queue instead of recursion.
+		 * Each cell is examined at most once (tracked by the visited bitmap), so stack usage stays constant regardless of region size.
+		 * @param origin is the index of the BLANK cell that was just revealed. It is not added to the result container by this function.
+		 * @param result points to a set where newly revealed cells will be placed.
+		 */
+		template<typename ContainerType = unordered_set<Minecell>>
+		void revealBlankRegion(const int& origin, ContainerType* const result) {
+			vector<int> blankQueue = {origin};		//revealed BLANK cells whose neighbors have not been examined yet
+			vector<int> visitedCells = {origin};	//every cell marked in the visited bitmap, so it can be cleared afterwards
+			floodVisited[origin] = true;
+			
+			for(size_t next = 0; next < blankQueue.size(); next++) {
+				for(const int& neighbor : getNeighbors(blankQueue[next])) {
+					if(floodVisited[neighbor]) {
+						continue;
+					}
+					floodVisited[neighbor] = true;
+					visitedCells.push_back(neighbor);
+					
+					const State neighborState = reveal(neighbor);
+					if(neighborState == FAIL) { //flagged or already revealed
+						continue;
+					}
+					
+					if(result != nullptr) {
+						result->insert(result->end(), Minecell(this, neighbor));
+					}
+					
+					if(neighborState == BLANK) {
+						blankQueue.push_back(neighbor);
+					}
+					
+					//Neighbors of a BLANK cell are never mines, so every reveal here is a safe space
+					if(--remainingSpaces == 0) {
+						win();
+					}
+				}
+			}
+			
+			for(const int& index : visitedCells) {
+				floodVisited[index] = false;
+			}
+		}
 	
 	public:
 		Minefield(
 				const COORD& desiredSize,
 				const int& desiredMines,
 				const COORD& desiredPosition,
-				const function<bool(const Minefield& field, const short& row, const short& col)>* const desiredFieldEvaluator
+				const function<bool(BoardView& view, const short& row, const short& col)>* const desiredFieldEvaluator,
+				const unsigned& desiredGenerationThreads = 1,
+				const boardbank::BoardBank* const desiredBank = nullptr
 		) :
 				Field(desiredSize.Y, desiredSize.X),
 				mines(desiredMines),
 				mineCount(desiredMines),
 				positionOffset(desiredPosition),
-				evaluate(desiredFieldEvaluator)
+				evaluate(desiredFieldEvaluator),
+				generationThreads(desiredGenerationThreads),
+				bank(desiredBank),
+				states(desiredSize.Y * desiredSize.X, UNINITIALIZED),
+				hidden(desiredSize.Y * desiredSize.X, true),
+				flagged(desiredSize.Y * desiredSize.X, false),
+				numbers(desiredSize.Y * desiredSize.X, 0),
+				wordsPerRow((desiredSize.X + 63) / 64),
+				mineBits(desiredSize.Y * wordsPerRow, 0),
+				neighborScratch(bitboard::numRowBands(desiredSize.Y, desiredSize.X) * bitboard::SCRATCH_ROWS * wordsPerRow, 0),
+				floodVisited(desiredSize.Y * desiredSize.X, false)
 		{
 			remainingSpaces = rows * cols - mines;
-			resetBoard();
+			startTime = 0;
+			endTime = 0;
 		}
 		
 		//Copy constructor
@@ -404,31 +769,32 @@ class Minefield final : public Field {
 				mineCount(other.mines),
 				positionOffset(other.positionOffset),
 				evaluate(other.evaluate),
-				gameStatus(other.gameStatus),
+				generationThreads(other.generationThreads),
+				bank(other.bank),
+				states(other.states),
+				hidden(other.hidden),
+				flagged(other.flagged),
+				numbers(other.numbers),
+				wordsPerRow(other.wordsPerRow),
+				mineBits(other.mineBits),
+				neighborScratch(other.neighborScratch),
+				floodVisited(other.floodVisited),
+				gameStatus(other.gameStatus.load()),
 				remainingSpaces(other.remainingSpaces),
 				startTime(other.startTime),
-				endTime(other.endTime)
-		{
-			cells = vector<vector<Cell*>>();
-			for(short row = 0; row < rows; row++) {
-				cells.push_back(vector<Cell*>());
-				for(short col = 0; col < cols; col++) {
-					cells.at(row).push_back(new Minecell(*other.at(row, col)));
-				}
-			}
-		}
+				endTime(other.endTime) {}
 		
 		/**
-		 * @return pointer to the cell at the given coordinates.
+		 * @return the cell at the given coordinates.
 		 */
-		Minecell* at(const short& row, const short& col) const {
-			return static_cast<Minecell*>(Field::at(row, col));
+		Minecell at(const short& row, const short& col) const {
+			return Minecell(this, indexOf(row, col));
 		}
 		
 		/**
-		 * @return pointer to the cell at the given screen coordinates.
+		 * @return the cell at the given screen coordinates.
 		 */
-		Minecell* at(const COORD& screenPosition) {
+		Minecell at(const COORD& screenPosition) const {
 			short row, col;
 			getFieldCoordinatesFromScreenCoord(screenPosition, row, col);
 			return at(row, col);
@@ -451,8 +817,8 @@ class Minefield final : public Field {
 		/**
 		 * @return a coordinate that holds the position of the given cell, in the screen coordinate system.
 		 */
-		const COORD getPositionOf(Minecell* cell) const {
-			return COORD{short(cell->col + positionOffset.X), short(cell->row + positionOffset.Y)};
+		const COORD getPositionOf(const Minecell& cell) const {
+			return COORD{short(colOf(cell.index) + positionOffset.X), short(rowOf(cell.index) + positionOffset.Y)};
 		}
 		
 		/**
@@ -476,6 +842,13 @@ class Minefield final : public Field {
 			return mineCount;
 		}
 		
+		/**
+		 * @return the number of safe spaces (not mines) that remain hidden.
+		 */
+		const int getRemainingSpaces() const {
+			return remainingSpaces;
+		}
+		
 		/**
 		 * @return the number of milliseconds since the game started. If the game has finished, return the game duration in milliseconds.
 		 */
@@ -490,16 +863,80 @@ class Minefield final : public Field {
 			}
 		}
 		
+		/**
+		 * Append this board to a board bank. The board must have been started by revealing one cell, and not played any further.
+		 * The board's opening is the blank region that first reveal uncovered, or just the revealed cell if it was a number.
+		 */
+		void appendTo(boardbank::BankWriter& writer) const {
+			vector<uint64_t> opening(mineBits.size(), 0);
+			for(int index = 0; index < rows * cols; index++) {
+				if(!hidden[index] && (states[index] == BLANK || remainingSpaces == rows * cols - mines - 1)) {
+					opening[rowOf(index) * wordsPerRow + colOf(index) / 64] |= uint64_t(1) << (colOf(index) % 64);
+				}
+			}
+			writer.append(mineBits.data(), opening.data());
+		}
+		
+		/**
+		 * Generate the board ahead of time for a first reveal at a random cell, so that the first reveal does not have to wait for generation.
+		 * The game stays unstarted: revealing the prepared cell first plays the prepared board, while revealing any other cell generates a new one.
+		 * May be called from a background thread, as long as the given generator is not shared with any other thread.
+		 * @return the cell the board was prepared for.
+		 */
+		Minecell prepare(mt19937& generator) {
+			const int index = uniform_int_distribution<>(0, rows * cols - 1)(generator);
+			return prepare(rowOf(index), colOf(index), generator);
+		}
+		
+		/**
+		 * Generate the board ahead of time for a first reveal at the given cell, e.g. on a background thread so that the game can keep handling input.
+		 * The game stays unstarted: revealing the prepared cell first plays the prepared board.
+		 * @param generator is the random generator to draw from. It must not be shared with any other thread.
+		 * @param control optionally reports progress, and allows generation to be abandoned or to fall back to a cheaper evaluator after a time budget.
+		 * If generation is abandoned, the board is left unprepared.
+		 * @return the cell the board was prepared for.
+		 */
+		Minecell prepare(const short& row, const short& col, mt19937& generator, GenerationControl* const control = nullptr) {
+			generationControl = control;
+			
+			//Evaluators play candidate boards, which needs the game PLAYING, so the game is only put back to unstarted once a board is ready
+			init(row, col, generator);
+			const bool generated = gameStatus == PLAYING;
+			generatedWithFallback = control != nullptr && control->usedFallback.load();
+			if(generatedWithFallback) {
+				LOGGER << "Board generation ran over its time budget, so the board was accepted by the fallback evaluator" << endl;
+			}
+			
+			generationControl = nullptr;
+			gameStatus = UNSTARTED;
+			preparedStart = generated ? indexOf(row, col) : -1;
+			return Minecell(this, indexOf(row, col));
+		}
+		
+		/**
+		 * @return whether the board ran over its generation time budget, so that it was only required to satisfy the fallback evaluator.
+		 */
+		const bool isGeneratedWithFallback() const {
+			return generatedWithFallback;
+		}
+		
+		/**
+		 * @return the cell the board was prepared for by prepare(), or a handle to no cell if the board was not prepared.
+		 */
+		Minecell getPreparedStart() const {
+			return preparedStart == -1 ? Minecell() : Minecell(this, preparedStart);
+		}
+		
 		/**
 		 * Attempt to flag the given cell
-		 * @param cell must point to a valid cell in this field.
-		 * @param result points to a set where pointers to newly flagged/unflagged cells will be placed.
+		 * @param cell must refer to a valid cell in this field.
+		 * @param result points to a set where newly flagged/unflagged cells will be placed.
 		 * @return the given cell.
 		 */
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* flagSpace(Minecell* cell, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell flagSpace(const Minecell& cell, ContainerType* const result = nullptr) {
 			if(gameStatus == PLAYING) {
-				const short flagActionStatus = cell->toggleFlag();
+				const short flagActionStatus = toggleFlag(cell.index);
 				mineCount -= flagActionStatus;
 				
 				if(result != nullptr && flagActionStatus != 0) {
@@ -510,30 +947,30 @@ class Minefield final : public Field {
 			return cell;
 		}
 		
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* flagSpace(const short& row, const short& col, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell flagSpace(const short& row, const short& col, ContainerType* const result = nullptr) {
 			return flagSpace(at(row, col), result);
 		}
 		
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* flagSpace(const COORD& screenPosition, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell flagSpace(const COORD& screenPosition, ContainerType* const result = nullptr) {
 			return flagSpace(at(screenPosition), result);
 		}
 		
 		/**
 		 * Attempt to reveal the given cell
-		 * @param cell must point to a valid cell in this field.
-		 * @param result points to a set where pointers to newly revealed cells will be placed.
+		 * @param cell must refer to a valid cell in this field.
+		 * @param result points to a set where newly revealed cells will be placed.
 		 * @return the given cell.
 		 */
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* revealSpace(Minecell* cell, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell revealSpace(Minecell cell, ContainerType* const result = nullptr) {
 			if(gameStatus == UNSTARTED) {
-				cell = init(cell->row, cell->col);
+				cell = init(rowOf(cell.index), colOf(cell.index), randomizer);
 			}
 			
 			if(gameStatus == PLAYING) {
-				const State cellState = cell->reveal();
+				const State cellState = reveal(cell.index);
 				
 				if(result != nullptr && cellState != FAIL) {
 					result->insert(result->end(), cell);
@@ -545,10 +982,7 @@ class Minefield final : public Field {
 						break;
 					}
 					case BLANK: {
-						unordered_set<Minecell*> neighbors = getAdjacentCells(cell);
-						for(Minecell* neighbor : neighbors) {
-							revealSpace(neighbor, result);
-						}
+						revealBlankRegion(cell.index, result);
 					}
 					case NUMBER: { //fall-through because these are common to both BLANK and NUMBER cases
 						if(--remainingSpaces == 0) {
@@ -561,40 +995,40 @@ class Minefield final : public Field {
 			return cell;
 		}
 		
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* revealSpace(const short& row, const short& col, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell revealSpace(const short& row, const short& col, ContainerType* const result = nullptr) {
 			return revealSpace(at(row, col), result);
 		}
 		
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* revealSpace(const COORD& screenPosition, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell revealSpace(const COORD& screenPosition, ContainerType* const result = nullptr) {
 			return revealSpace(at(screenPosition), result);
 		}
 		
 		/**
 		 * Attempt to chord the given cell
-		 * @param cell must point to a valid cell in this field.
-		 * @param result points to a set where pointers to newly revealed cells will be placed.
+		 * @param cell must refer to a valid cell in this field.
+		 * @param result points to a set where newly revealed cells will be placed.
 		 * @return the given cell.
 		 */
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* chordSpace(Minecell* cell, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell chordSpace(const Minecell& cell, ContainerType* const result = nullptr) {
 			if(gameStatus == PLAYING) {
-				const short number = cell->getNumber();
+				const short number = cell.getNumber();
 				if(number) {
 					//Count adjacent flags
-					unordered_set<Minecell*> neighbors = getAdjacentCells(cell);
+					const Neighbors neighbors = getNeighbors(cell.index);
 					short numNeighboringFlags = 0;
-					for(Minecell* neighbor : neighbors) {
-						if(neighbor->isFlagged()) {
+					for(const int& neighbor : neighbors) {
+						if(flagged[neighbor]) {
 							numNeighboringFlags++;
 						}
 					}
 					
 					//If count is correct, reveal all non-flagged cells (attempt to reveal all adjacent cells, flagged cells will be ignored)
 					if(numNeighboringFlags == number) {
-						for(Minecell* neighbor : neighbors) {
-							revealSpace(neighbor, result);
+						for(const int& neighbor : neighbors) {
+							revealSpace(Minecell(this, neighbor), result);
 						}
 					}
 				}
@@ -603,15 +1037,173 @@ class Minefield final : public Field {
 			return cell;
 		}
 		
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* chordSpace(const short& row, const short& col, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell chordSpace(const short& row, const short& col, ContainerType* const result = nullptr) {
 			return chordSpace(at(row, col), result);
 		}
 		
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* chordSpace(const COORD& screenPosition, ContainerType* const result = nullptr) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell chordSpace(const COORD& screenPosition, ContainerType* const result = nullptr) {
 			return chordSpace(at(screenPosition), result);
 		}
 };
 
+const short Minecell::getRow() const {
+	return field->rowOf(index);
+}
+
+const short Minecell::getCol() const {
+	return field->colOf(index);
+}
+
+/**
+ * Attempt to get the cell's state
+ * @return the state, if it is public knowledge. Else, return FAIL State to indicate that the requested information is not available.
+ */
+const State Minecell::getState() const {
+	if(!field->hidden[index]) {
+		return State(field->states[index]);
+	}
+	else {
+		return FAIL;
+	}
+}
+
+/**
+ * Attempt to get the cell's number
+ * @return the number, if it is public knowledge. Else, return 0 to indicate that the requested information is not available.
+ */
+const short Minecell::getNumber() const {
+	if(!field->hidden[index] && field->states[index] == NUMBER) {
+		return field->numbers[index];
+	}
+	else {
+		return 0;
+	}
+}
+
+/**
+ * Whether the cell is flagged or not
+ * @return true if the cell is flagged.
+ */
+const bool Minecell::isFlagged() const {
+	return field->flagged[index];
+}
+
+/**
+ * Read-only view of a freshly generated Minefield, handed to evaluators in place of a copy of the board.
+ * Queries read the minefield's layers directly.
+ * Evaluators which need to play the board out (e.g. with the solver) can do so speculatively through play():
+ * every reveal and flag made while the view exists is journaled, and rolled back when the view is destroyed.
+ */
+class BoardView final {
+	private:
+		Minefield& field;
+		mt19937& generator;					//random generator of the thread generating this board
+		
+		//game progress when the view was created, restored on destruction
+		const GameStatus savedGameStatus;
+		const int savedRemainingSpaces;
+		const int savedMineCount;
+	
+	public:
+		BoardView(Minefield& desiredField, mt19937& desiredGenerator
+		) :		field(desiredField),
+				generator(desiredGenerator),
+				savedGameStatus(desiredField.gameStatus),
+				savedRemainingSpaces(desiredField.remainingSpaces),
+				savedMineCount(desiredField.mineCount)
+		{
+			field.speculating = true;
+		}
+		
+		~BoardView() {
+			for(const int& index : field.speculationJournal) {
+				field.hidden[index] = true;
+				field.flagged[index] = false;
+			}
+			field.speculationJournal.clear();
+			field.speculating = false;
+			
+			field.gameStatus = savedGameStatus;
+			field.remainingSpaces = savedRemainingSpaces;
+			field.mineCount = savedMineCount;
+		}
+		
+		BoardView(const BoardView&) = delete;
+		void operator=(const BoardView&) = delete;
+		
+		const short getRows() const {
+			return field.getRows();
+		}
+		
+		const short getCols() const {
+			return field.getCols();
+		}
+		
+		const int getMines() const {
+			return field.getMines();
+		}
+		
+		const bool isValidSpace(const short& row, const short& col) const {
+			return field.isValidSpace(row, col);
+		}
+		
+		/**
+		 * @return whether the given cell holds a mine. Reads the mine layer directly, in constant time.
+		 */
+		const bool isMine(const short& row, const short& col) const {
+			return field.hasMine(field.indexOf(row, col));
+		}
+		
+		/**
+		 * @return whether the evaluator should give up on this board: because generation was abandoned, because another candidate generated in parallel was already accepted,
+		 * or because generation has run over its time budget. Long-running evaluators should check it regularly, not just between attempts.
+		 */
+		const bool isCancelled() const {
+			return field.isGenerationAbandoned() || (field.generationCancelled != nullptr && field.generationCancelled->load()) || field.isGenerationOverBudget();
+		}
+		
+		/**
+		 * @return a random generator which is safe to use on the thread evaluating this board.
+		 */
+		mt19937& getRandomizer() {
+			return generator;
+		}
+		
+		/**
+		 * Move a mine from one cell to another which has none, recomputing the affected numbers.
+		 * Unlike speculative play, this changes the board itself and is NOT rolled back when the view is destroyed.
+		 */
+		void relocateMine(const short& fromRow, const short& fromCol, const short& toRow, const short& toCol) {
+			field.relocateMine(field.indexOf(fromRow, fromCol), field.indexOf(toRow, toCol));
+		}
+		
+		/**
+		 * @return the minefield itself, for speculative play. All reveals and flags are undone when this view is destroyed.
+		 */
+		Minefield& play() {
+			return field;
+		}
+};
+
+/**
+ * Ask the evaluator whether the freshly generated board is valid to play, through a BoardView so that the board is never copied.
+ * Once generation has run over its time budget, the fallback evaluator is asked instead.
+ * @return whether the board was accepted.
+ */
+bool Minefield::evaluateBoard(const short& row, const short& col, mt19937& generator) {
+	const function<bool(BoardView& view, const short& row, const short& col)>* evaluator = evaluate;
+	if(generationControl != nullptr) {
+		generationControl->candidatesEvaluated++;
+		if(isGenerationOverBudget()) {
+			generationControl->usedFallback = true;
+			evaluator = generationControl->fallbackEvaluator;
+		}
+	}
+	
+	BoardView view(*this, generator);
+	return (*evaluator)(view, row, col);
+}
+
 } using namespace field;
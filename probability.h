@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Exact mine probabilities for the hidden cells of a partially solved board.
+ *
+ * The frontier (hidden cells next to revealed numbers) is described by constraints: "exactly N of
+ * these cells are mines". Constraints which share no cells are independent, so the frontier is
+ * split into connected components, and each component's valid mine configurations are enumerated
+ * separately by backtracking, counted by how many mines they use. The components are then combined
+ * with the cells off the frontier (the interior), which may hold any of the remaining mines:
+ * a combination using t frontier mines can be completed in C(interior, remaining - t) ways.
+ *
+ * A component whose enumeration would take too long (e.g. a long connected frontier on a large
+ * board) is approximated instead, from the density of its constraints, so that the probabilities
+ * are always available in bounded time. Only that component's probabilities are then approximate.
+ */
+namespace probability {
+
+// Minimum number of frontier cells before components are enumerated on several threads
+constexpr int PARALLEL_THRESHOLD = 64;
+
+// Upper bound on the work spent enumerating one component (cells assigned, plus cells tallied for each valid configuration), after which the component is approximated
+constexpr long long ENUMERATION_BUDGET = 1 << 24;
+
+// Components with more cells than this are approximated without being enumerated, since their tallies alone would take (cells + 1) * cells numbers
+constexpr int MAX_ENUMERATED_CELLS = 512;
+
+struct Constraint {
+	std::vector<int> cells;					//identifiers of the hidden cells in this constraint
+	int mines;								//number of mines among them
+};
+
+struct Probabilities {
+	std::unordered_map<int, double> cells;	//mine probability of every cell that appears in a constraint
+	double interior = 0;					//mine probability of every other hidden cell
+};
+
+/**
+ * One connected group of constraints, and the results of enumerating its mine configurations.
+ */
+struct Component {
+	std::vector<int> cells;								//cell identifiers, in the order they are assigned
+	std::vector<std::vector<int>> cellConstraints;		//for each cell, the (component-local) constraints it appears in
+	std::vector<int> constraintMines;
+	std::vector<int> constraintSizes;
+	
+	bool exact = true;									//whether the component was enumerated, rather than approximated
+	std::vector<long double> configurations;			//[k] number of valid configurations with k mines, or a weight proportional to it if approximated
+	std::vector<std::vector<long double>> cellMines;	//[k][cell] number of those configurations in which the cell is a mine. Empty if approximated
+	std::vector<long double> density;					//[cell] estimated mine probability, if approximated
+	
+	/**
+	 * Estimate the component instead of enumerating it: each cell is a mine with the average density (mines / cells) of its constraints,
+	 * and the number of mines the component holds is spread binomially around the sum of those densities.
+	 */
+	void approximate() {
+		const int numCells = cells.size();
+		exact = false;
+		cellMines.clear();
+		
+		density.assign(numCells, 0);
+		long double expectedMines = 0;
+		for(int i = 0; i < numCells; i++) {
+			for(const int& constraint : cellConstraints[i]) {
+				density[i] += (long double)constraintMines[constraint] / constraintSizes[constraint];
+			}
+			density[i] = std::min<long double>(1, std::max<long double>(0, density[i] / cellConstraints[i].size()));
+			expectedMines += density[i];
+		}
+		
+		configurations.assign(numCells + 1, 0);
+		const long double p = expectedMines / numCells;
+		if(p <= 0) {
+			configurations[0] = 1;
+		}
+		else if(p >= 1) {
+			configurations[numCells] = 1;
+		}
+		else {
+			for(int k = 0; k <= numCells; k++) {
+				configurations[k] = std::exp(std::lgamma((long double)numCells + 1) - std::lgamma((long double)k + 1) - std::lgamma((long double)numCells - k + 1)
+						+ k * std::log(p) + (numCells - k) * std::log1p(-p));
+			}
+		}
+	}
+	
+	/**
+	 * Count every valid configuration of this component, by assigning each cell in turn and backtracking as soon as a constraint can no longer be met.
+	 * If that takes more than ENUMERATION_BUDGET, the component is approximated instead.
+	 */
+	void enumerate() {
+		const int numCells = cells.size();
+		if(numCells > MAX_ENUMERATED_CELLS) {
+			approximate();
+			return;
+		}
+		
+		configurations.assign(numCells + 1, 0);
+		cellMines.assign(numCells + 1, std::vector<long double>(numCells, 0));
+		
+		std::vector<int> remainingMines = constraintMines;
+		std::vector<int> remainingCells = constraintSizes;
+		std::vector<char> assignment(numCells, 0);
+		long long work = 0;
+		
+		auto assign = [&](auto& self, const int& cell, const int& minesSoFar) -> void {
+			if(work > ENUMERATION_BUDGET) {
+				return;
+			}
+			work++;
+			
+			if(cell == numCells) {
+				work += numCells;
+				configurations[minesSoFar]++;
+				for(int i = 0; i < numCells; i++) {
+					cellMines[minesSoFar][i] += assignment[i];
+				}
+				return;
+			}
+			
+			for(char isMine = 0; isMine <= 1; isMine++) {
+				bool feasible = true;
+				for(const int& constraint : cellConstraints[cell]) {
+					remainingCells[constraint]--;
+					remainingMines[constraint] -= isMine;
+					feasible = feasible && remainingMines[constraint] >= 0 && remainingMines[constraint] <= remainingCells[constraint];
+				}
+				
+				if(feasible) {
+					assignment[cell] = isMine;
+					self(self, cell + 1, minesSoFar + isMine);
+				}
+				
+				for(const int& constraint : cellConstraints[cell]) {
+					remainingCells[constraint]++;
+					remainingMines[constraint] += isMine;
+				}
+			}
+			assignment[cell] = 0;
+		};
+		assign(assign, 0, 0);
+		
+		if(work > ENUMERATION_BUDGET) {
+			approximate();
+		}
+	}
+};
+
+/**
+ * @return the convolution of two mine count distributions.
+ */
+std::vector<long double> convolve(const std::vector<long double>& a, const std::vector<long double>& b) {
+	std::vector<long double> result(a.size() + b.size() - 1, 0);
+	for(size_t i = 0; i < a.size(); i++) {
+		if(a[i] == 0) {
+			continue;
+		}
+		for(size_t j = 0; j < b.size(); j++) {
+			result[i + j] += a[i] * b[j];
+		}
+	}
+	return result;
+}
+
+/**
+ * Split the constraints into connected components (constraints are connected when they share a cell).
+ */
+std::vector<Component> findComponents(const std::vector<Constraint>& constraints) {
+	// Union-find over constraints, joined through the cells they share
+	std::vector<int> parent(constraints.size());
+	std::iota(parent.begin(), parent.end(), 0);
+	auto root = [&parent](int constraint) {
+		while(parent[constraint] != constraint) {
+			constraint = parent[constraint] = parent[parent[constraint]];
+		}
+		return constraint;
+	};
+	
+	std::unordered_map<int, int> firstConstraintOfCell;
+	for(size_t constraint = 0; constraint < constraints.size(); constraint++) {
+		for(const int& cell : constraints[constraint].cells) {
+			auto found = firstConstraintOfCell.emplace(cell, constraint);
+			if(!found.second) {
+				parent[root(constraint)] = root(found.first->second);
+			}
+		}
+	}
+	
+	std::unordered_map<int, int> componentOfRoot;
+	std::vector<Component> components;
+	std::vector<std::unordered_map<int, int>> localCells;
+	for(size_t constraint = 0; constraint < constraints.size(); constraint++) {
+		auto found = componentOfRoot.emplace(root(constraint), components.size());
+		if(found.second) {
+			components.emplace_back();
+			localCells.emplace_back();
+		}
+		Component& component = components[found.first->second];
+		std::unordered_map<int, int>& local = localCells[found.first->second];
+		
+		// Cells are numbered in the order their constraints are met, which keeps each constraint's cells close together in the assignment order
+		const int localConstraint = component.constraintMines.size();
+		component.constraintMines.push_back(constraints[constraint].mines);
+		component.constraintSizes.push_back(constraints[constraint].cells.size());
+		for(const int& cell : constraints[constraint].cells) {
+			auto added = local.emplace(cell, component.cells.size());
+			if(added.second) {
+				component.cells.push_back(cell);
+				component.cellConstraints.emplace_back();
+			}
+			component.cellConstraints[added.first->second].push_back(localConstraint);
+		}
+	}
+	
+	return components;
+}
+
+/**
+ * Compute the exact mine probability of every hidden cell, given the frontier constraints.
+ * Every combination of mine positions which satisfies all constraints and uses exactly the remaining mines is considered equally likely.
+ * @param interiorCells is the number of hidden cells which appear in no constraint.
+ * @param remainingMines is the number of mines among all hidden cells.
+ */
+Probabilities compute(const std::vector<Constraint>& constraints, const int& interiorCells, const int& remainingMines) {
+	std::vector<Component> components = findComponents(constraints);
+	
+	int frontierCells = 0;
+	for(const Component& component : components) {
+		frontierCells += component.cells.size();
+	}
+	
+	// Enumerate the components, on several threads when there is enough work to be worth it
+	const int numThreads = frontierCells < PARALLEL_THRESHOLD
+			? 1
+			: std::min<int>(std::max(1u, std::thread::hardware_concurrency()), components.size());
+	if(numThreads <= 1) {
+		for(Component& component : components) {
+			component.enumerate();
+		}
+	}
+	else {
+		// Largest components first, so that one big component does not start last
+		std::vector<Component*> queue;
+		for(Component& component : components) {
+			queue.push_back(&component);
+		}
+		std::sort(queue.begin(), queue.end(), [](const Component* a, const Component* b) {
+			return a->cells.size() > b->cells.size();
+		});
+		
+		std::atomic<size_t> next(0);
+		std::vector<std::thread> workers;
+		for(int worker = 0; worker < numThreads; worker++) {
+			workers.emplace_back([&queue, &next]() {
+				for(size_t item = next++; item < queue.size(); item = next++) {
+					queue[item]->enumerate();
+				}
+			});
+		}
+		for(std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+	
+	// completions[t]: ways to place the remaining mines in the interior when the frontier holds t mines, scaled to avoid overflow
+	std::vector<long double> logCompletions(frontierCells + 1, -INFINITY);
+	long double maxLogCompletion = -INFINITY;
+	for(int t = 0; t <= frontierCells; t++) {
+		const int interiorMines = remainingMines - t;
+		if(interiorMines >= 0 && interiorMines <= interiorCells) {
+			logCompletions[t] = std::lgamma((long double)interiorCells + 1) - std::lgamma((long double)interiorMines + 1) - std::lgamma((long double)interiorCells - interiorMines + 1);
+			maxLogCompletion = std::max(maxLogCompletion, logCompletions[t]);
+		}
+	}
+	std::vector<long double> completions(frontierCells + 1, 0);
+	for(int t = 0; t <= frontierCells; t++) {
+		if(logCompletions[t] != -INFINITY) {
+			completions[t] = std::exp(logCompletions[t] - maxLogCompletion);
+		}
+	}
+	
+	// prefix[c] combines components [0, c), suffix[c] combines components [c, end)
+	const size_t numComponents = components.size();
+	std::vector<std::vector<long double>> prefix(numComponents + 1, {1});
+	std::vector<std::vector<long double>> suffix(numComponents + 1, {1});
+	for(size_t c = 0; c < numComponents; c++) {
+		prefix[c + 1] = convolve(prefix[c], components[c].configurations);
+	}
+	for(size_t c = numComponents; c-- > 0;) {
+		suffix[c] = convolve(components[c].configurations, suffix[c + 1]);
+	}
+	const std::vector<long double>& all = prefix[numComponents];
+	
+	long double total = 0;
+	long double interiorMineWeight = 0;
+	for(size_t t = 0; t < all.size(); t++) {
+		total += all[t] * completions[t];
+		if(interiorCells > 0) {
+			interiorMineWeight += all[t] * completions[t] * (remainingMines - (long double)t) / interiorCells;
+		}
+	}
+	if(total <= 0) {
+		throw std::logic_error("No placement of the remaining mines satisfies every possibility set");
+	}
+	
+	Probabilities result;
+	result.interior = interiorMineWeight / total;
+	for(size_t c = 0; c < numComponents; c++) {
+		const Component& component = components[c];
+		const std::vector<long double> others = convolve(prefix[c], suffix[c + 1]);
+		
+		// weightOfMines[k]: weight of all combinations in which this component holds k mines, divided by this component's own configurations
+		std::vector<long double> weightOfMines(component.configurations.size(), 0);
+		for(size_t k = 0; k < weightOfMines.size(); k++) {
+			for(size_t j = 0; j < others.size() && k + j < completions.size(); j++) {
+				weightOfMines[k] += others[j] * completions[k + j];
+			}
+		}
+		
+		if(!component.exact) {
+			// Scale the cells' densities so that they add up to the number of mines the component is expected to hold, given every other component and the interior
+			long double expectedMines = 0;
+			long double densitySum = 0;
+			for(size_t k = 0; k < weightOfMines.size(); k++) {
+				expectedMines += k * component.configurations[k] * weightOfMines[k] / total;
+			}
+			for(const long double& cellDensity : component.density) {
+				densitySum += cellDensity;
+			}
+			for(size_t i = 0; i < component.cells.size(); i++) {
+				result.cells[component.cells[i]] = densitySum > 0 ? std::min<long double>(1, component.density[i] * expectedMines / densitySum) : 0;
+			}
+			continue;
+		}
+		
+		for(size_t i = 0; i < component.cells.size(); i++) {
+			long double mineWeight = 0;
+			for(size_t k = 0; k < weightOfMines.size(); k++) {
+				mineWeight += component.cellMines[k][i] * weightOfMines[k];
+			}
+			result.cells[component.cells[i]] = mineWeight / total;
+		}
+	}
+	
+	return result;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A small, self-contained CDCL (conflict-driven clause learning) SAT solver, for proving moves on
+ * frontiers which are too large to enumerate.
+ *
+ * Clauses are added once and kept for the solver's lifetime, and so are the clauses it learns from
+ * conflicts: callers which only ever add facts (e.g. the constraints of a single game) get faster
+ * as they ask more questions. Questions are asked with assumptions, literals which hold for one
+ * call of solve() only.
+ *
+ * The search is the textbook one: unit propagation with two watched literals per clause, first-UIP
+ * conflict analysis, activity-based branching with phase saving, and restarts at a growing
+ * interval. Learned clauses are never deleted.
+ */
+namespace sat {
+
+// A literal is a variable (2 * variable) or its negation (2 * variable + 1)
+using Literal = int;
+
+inline Literal positive(const int& variable) {
+	return variable * 2;
+}
+
+inline Literal negative(const int& variable) {
+	return variable * 2 + 1;
+}
+
+inline int variableOf(const Literal& literal) {
+	return literal >> 1;
+}
+
+enum Result {
+	SATISFIABLE,
+	UNSATISFIABLE,
+	UNKNOWN		//the conflict budget ran out first
+};
+
+class Solver {
+	private:
+		static constexpr int UNASSIGNED = -1;
+		static constexpr int NO_REASON = -1;
+		
+		std::vector<std::vector<Literal>> clauses;
+		std::vector<std::vector<int>> watches;		//[literal] clauses which watch the literal (it is one of their first two)
+		
+		std::vector<int> assignment;				//[variable] 1 if true, 0 if false, or UNASSIGNED
+		std::vector<int> levels;					//[variable] decision level at which the variable was assigned
+		std::vector<int> reasons;					//[variable] clause which implied the variable, or NO_REASON for decisions
+		std::vector<Literal> trail;					//assigned literals, in assignment order
+		std::vector<size_t> levelStarts;			//[level - 1] position in the trail where the level starts
+		size_t propagated = 0;						//position in the trail up to which assignments have been propagated
+		
+		std::vector<double> activity;				//[variable] how often the variable has been involved in recent conflicts
+		double activityIncrement = 1;
+		std::vector<char> savedPhases;				//[variable] last value the variable was assigned
+		std::vector<char> seen;						//[variable] scratch space for conflict analysis
+		std::vector<char> model;					//[variable] value in the last satisfying assignment
+		
+		bool contradictory = false;					//whether the clauses are unsatisfiable without any assumptions
+		
+		int decisionLevel() const {
+			return levelStarts.size();
+		}
+		
+		/**
+		 * @return 1 if the literal is true, 0 if it is false, or UNASSIGNED.
+		 */
+		int valueOf(const Literal& literal) const {
+			const int variableValue = assignment[variableOf(literal)];
+			return variableValue == UNASSIGNED ? UNASSIGNED : variableValue ^ (literal & 1);
+		}
+		
+		void assign(const Literal& literal, const int& reason) {
+			const int variable = variableOf(literal);
+			assignment[variable] = !(literal & 1);
+			levels[variable] = decisionLevel();
+			reasons[variable] = reason;
+			trail.push_back(literal);
+		}
+		
+		/**
+		 * Watch the first two literals of a clause, which must already be in the clause list.
+		 */
+		void watch(const int& clause) {
+			watches[clauses[clause][0]].push_back(clause);
+			watches[clauses[clause][1]].push_back(clause);
+		}
+		
+		/**
+		 * Propagate every assignment on the trail which has not been propagated yet.
+		 * @return the clause which became false, or NO_REASON if there was no conflict.
+		 */
+		int propagate() {
+			while(propagated < trail.size()) {
+				const Literal falseLiteral = trail[propagated++] ^ 1;
+				std::vector<int>& watching = watches[falseLiteral];
+				
+				for(size_t i = 0; i < watching.size();) {
+					const int clauseIndex = watching[i];
+					std::vector<Literal>& clause = clauses[clauseIndex];
+					if(clause[0] == falseLiteral) {
+						std::swap(clause[0], clause[1]);
+					}
+					
+					if(valueOf(clause[0]) == 1) {
+						i++;
+						continue;
+					}
+					
+					// Look for another literal which is not false to watch instead
+					bool moved = false;
+					for(size_t candidate = 2; candidate < clause.size(); candidate++) {
+						if(valueOf(clause[candidate]) != 0) {
+							std::swap(clause[1], clause[candidate]);
+							watches[clause[1]].push_back(clauseIndex);
+							watching[i] = watching.back();
+							watching.pop_back();
+							moved = true;
+							break;
+						}
+					}
+					if(moved) {
+						continue;
+					}
+					
+					// Every literal except the first is false
+					if(valueOf(clause[0]) == 0) {
+						return clauseIndex;
+					}
+					assign(clause[0], clauseIndex);
+					i++;
+				}
+			}
+			return NO_REASON;
+		}
+		
+		void bumpActivity(const int& variable) {
+			activity[variable] += activityIncrement;
+			if(activity[variable] > 1e100) {
+				for(double& value : activity) {
+					value *= 1e-100;
+				}
+				activityIncrement *= 1e-100;
+			}
+		}
+		
+		/**
+		 * Find the first-UIP clause for a conflict: the clause, implied by the clauses involved in the conflict, in which only one literal was assigned at the current decision level.
+		 * @param learned receives the clause, with the literal from the current level first and a literal from the highest remaining level second.
+		 * @return the decision level to go back to, where the learned clause implies its first literal.
+		 */
+		int analyze(int conflict, std::vector<Literal>& learned) {
+			learned.assign(1, 0);
+			int pathsAtCurrentLevel = 0;
+			size_t trailPosition = trail.size();
+			Literal resolvedLiteral = 0;
+			size_t firstLiteral = 0; //reason clauses start with the literal they implied, which is the one being resolved away
+			
+			do {
+				const std::vector<Literal>& clause = clauses[conflict];
+				for(size_t i = firstLiteral; i < clause.size(); i++) {
+					const int variable = variableOf(clause[i]);
+					if(seen[variable] || levels[variable] == 0) {
+						continue;
+					}
+					seen[variable] = true;
+					bumpActivity(variable);
+					if(levels[variable] == decisionLevel()) {
+						pathsAtCurrentLevel++;
+					}
+					else {
+						learned.push_back(clause[i]);
+					}
+				}
+				
+				// Resolve on the most recently assigned literal at the current level which is part of the conflict
+				while(!seen[variableOf(trail[--trailPosition])]) {}
+				resolvedLiteral = trail[trailPosition];
+				seen[variableOf(resolvedLiteral)] = false;
+				conflict = reasons[variableOf(resolvedLiteral)];
+				firstLiteral = 1;
+				pathsAtCurrentLevel--;
+			} while(pathsAtCurrentLevel > 0);
+			learned[0] = resolvedLiteral ^ 1;
+			
+			int backtrackLevel = 0;
+			for(size_t i = 1; i < learned.size(); i++) {
+				seen[variableOf(learned[i])] = false;
+				if(levels[variableOf(learned[i])] > backtrackLevel) {
+					backtrackLevel = levels[variableOf(learned[i])];
+					std::swap(learned[1], learned[i]);
+				}
+			}
+			activityIncrement *= 1.05;
+			return backtrackLevel;
+		}
+		
+		void backtrack(const int& level) {
+			if(decisionLevel() <= level) {
+				return;
+			}
+			for(size_t i = trail.size(); i-- > levelStarts[level];) {
+				const int variable = variableOf(trail[i]);
+				savedPhases[variable] = assignment[variable];
+				assignment[variable] = UNASSIGNED;
+				reasons[variable] = NO_REASON;
+			}
+			trail.resize(levelStarts[level]);
+			levelStarts.resize(level);
+			propagated = trail.size();
+		}
+		
+		/**
+		 * @return the unassigned decision variable with the highest activity, as a literal in its saved phase, or -1 if every decision variable is assigned.
+		 */
+		Literal pickBranch(const std::vector<int>& decisionVariables) const {
+			int best = -1;
+			for(const int& variable : decisionVariables) {
+				if(assignment[variable] == UNASSIGNED && (best < 0 || activity[variable] > activity[best])) {
+					best = variable;
+				}
+			}
+			if(best < 0) {
+				return -1;
+			}
+			return savedPhases[best] ? positive(best) : negative(best);
+		}
+	
+	public:
+		/**
+		 * @return the number of a new variable.
+		 */
+		int newVariable() {
+			const int variable = assignment.size();
+			assignment.push_back(UNASSIGNED);
+			levels.push_back(0);
+			reasons.push_back(NO_REASON);
+			activity.push_back(0);
+			savedPhases.push_back(false);
+			seen.push_back(false);
+			model.push_back(false);
+			watches.emplace_back();
+			watches.emplace_back();
+			return variable;
+		}
+		
+		int numVariables() const {
+			return assignment.size();
+		}
+		
+		/**
+		 * Add a clause (a disjunction of literals) which must hold from now on.
+		 * @return false if the clauses have become unsatisfiable.
+		 */
+		bool addClause(std::vector<Literal> clause) {
+			if(contradictory) {
+				return false;
+			}
+			backtrack(0);
+			
+			// Drop literals which are already false, and the whole clause if it already holds
+			std::sort(clause.begin(), clause.end());
+			clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+			size_t kept = 0;
+			for(size_t i = 0; i < clause.size(); i++) {
+				if(valueOf(clause[i]) == 1 || (i + 1 < clause.size() && clause[i + 1] == (clause[i] ^ 1))) {
+					return true;
+				}
+				if(valueOf(clause[i]) == UNASSIGNED) {
+					clause[kept++] = clause[i];
+				}
+			}
+			clause.resize(kept);
+			
+			if(clause.empty()) {
+				contradictory = true;
+				return false;
+			}
+			if(clause.size() == 1) {
+				assign(clause[0], NO_REASON);
+				contradictory = propagate() != NO_REASON;
+				return !contradictory;
+			}
+			clauses.push_back(clause);
+			watch(clauses.size() - 1);
+			return true;
+		}
+		
+		/**
+		 * Search for an assignment which satisfies every clause and every assumption.
+		 * @param decisionVariables are the only variables the search branches on. Any variable outside of it must be one that can always be given a value which satisfies its clauses, once every decision variable is assigned.
+		 * @param conflictBudget is the number of conflicts after which the search gives up.
+		 */
+		Result solve(const std::vector<Literal>& assumptions, const std::vector<int>& decisionVariables, const std::uint64_t& conflictBudget) {
+			if(contradictory) {
+				return UNSATISFIABLE;
+			}
+			backtrack(0);
+			
+			std::uint64_t conflicts = 0;
+			std::uint64_t restartInterval = 64;
+			std::uint64_t conflictsSinceRestart = 0;
+			std::vector<Literal> learned;
+			while(true) {
+				const int conflict = propagate();
+				if(conflict != NO_REASON) {
+					if(decisionLevel() == 0) {
+						contradictory = true;
+						return UNSATISFIABLE;
+					}
+					if(++conflicts > conflictBudget) {
+						backtrack(0);
+						return UNKNOWN;
+					}
+					conflictsSinceRestart++;
+					
+					const int backtrackLevel = analyze(conflict, learned);
+					backtrack(backtrackLevel);
+					if(learned.size() == 1) {
+						assign(learned[0], NO_REASON);
+					}
+					else {
+						clauses.push_back(learned);
+						watch(clauses.size() - 1);
+						assign(learned[0], clauses.size() - 1);
+					}
+					continue;
+				}
+				
+				if(conflictsSinceRestart >= restartInterval) {
+					backtrack(0);
+					conflictsSinceRestart = 0;
+					restartInterval += restartInterval / 2;
+					continue;
+				}
+				
+				// Assumptions take the first decision levels, one each
+				Literal next = -1;
+				while(decisionLevel() < static_cast<int>(assumptions.size())) {
+					const Literal assumption = assumptions[decisionLevel()];
+					if(valueOf(assumption) == 0) {
+						backtrack(0);
+						return UNSATISFIABLE;
+					}
+					if(valueOf(assumption) == UNASSIGNED) {
+						next = assumption;
+						break;
+					}
+					levelStarts.push_back(trail.size()); //already holds, so its level is empty
+				}
+				if(next < 0) {
+					next = pickBranch(decisionVariables);
+				}
+				if(next < 0) {
+					for(const int& variable : decisionVariables) {
+						model[variable] = assignment[variable] == 1;
+					}
+					backtrack(0);
+					return SATISFIABLE;
+				}
+				
+				levelStarts.push_back(trail.size());
+				assign(next, NO_REASON);
+			}
+		}
+		
+		/**
+		 * @return the variable's value in the assignment found by the last successful solve(). Only decision variables are recorded.
+		 */
+		bool modelValue(const int& variable) const {
+			return model[variable];
+		}
+};
+
+}
\ No newline at end of file
@@ -132,6 +132,9 @@ class Settings {
 			{"playerName", ""},
 			{"solverModeDelay", "-1"},
 			{"solverModeGameEndPauseLength", "10"},
+			{"generationThreads", "0"},
+			{"generationTimeBudget", "5000"},
+			{"fallbackEvaluator", "safeStartPlus"},
 			{"highScores", ""}
 		};
 		
@@ -193,7 +196,7 @@ class Settings {
 			saveFile.close();
 		}
 		
-		const function<bool(const Minefield& field, const short& row, const short& col)>* getEvaluator() {
+		const function<bool(BoardView& view, const short& row, const short& col)>* getEvaluator() {
 			return &field::evaluators::evaluator[settings["evaluator"]];
 		}
 		
@@ -253,6 +256,25 @@ class Settings {
 			settings["solverModeGameEndPauseLength"] = to_string(numIterations);
 		}
 		
+		/**
+		 * @return the number of threads to generate boards on. A setting of 0 means one per hardware thread.
+		 */
+		const unsigned getGenerationThreads() {
+			const int threads = stoi(settings["generationThreads"]);
+			return threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+		}
+		
+		/**
+		 * @return the number of milliseconds that generating a board for the first click may take before falling back to the fallback evaluator, or -1 for no limit.
+		 */
+		const int getGenerationTimeBudget() {
+			return stoi(settings["generationTimeBudget"]);
+		}
+		
+		const function<bool(BoardView& view, const short& row, const short& col)>* getFallbackEvaluator() {
+			return &field::evaluators::evaluator[settings["fallbackEvaluator"]];
+		}
+		
 		const set<HighScore, HighScoreComparator>& getHighScores() const {
 			return highScores;
 		}
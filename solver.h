@@ -1,6 +1,14 @@
 #include "ms.h"
-#include "partitioned_value_reorderable_list.h"
+#include "indexed_partitioned_value_reorderable_list.h"
+#include "probability.h"
+#include "sat.h"
+#include "deduction.h"
+#include <bitset>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 
 namespace solver {
 	
@@ -8,6 +16,9 @@ constexpr size_t LIST_PARTITION_FRONT = 0;
 constexpr size_t LIST_PARTITION_MIDDLE = 1;
 constexpr size_t LIST_PARTITION_BACK = 2;
 
+// Boards with at least this many cells are solved in sparse mode by default (see Solver), where the solver only keeps the cells it is working with
+constexpr int SPARSE_THRESHOLD = 1 << 22;
+
 class NoValidMoveException : public exception {
 public:
 	const char* what() const noexcept override {
@@ -15,89 +26,341 @@ public:
 	}
 };
 
-class Solvercell;
+/**
+ * Outcome of an attempt to advance the solver, as reported by the exception-free API (tryStep and the like).
+ * The throwing API (step and the like) reports STUCK as a NoValidMoveException and the other failures as a logic_error.
+ */
+enum StepStatus {
+	MOVED,			//a move was made
+	STUCK,			//no move can be made without guessing
+	FINISHED,		//the game is won or lost
+	INCONSISTENT	//the possibility sets contradict each other or the minefield, so no move can be trusted until the solver is reset
+};
+
+// A possibility set holds one bit per neighbor of its number cell: bit i stands for the neighbor at (NEIGHBOR_ROW_OFFSETS[i], NEIGHBOR_COL_OFFSETS[i]) from it
+constexpr short NEIGHBOR_ROW_OFFSETS[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+constexpr short NEIGHBOR_COL_OFFSETS[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+/**
+ * @return the direction (i.e. bit in a possibility set) of the neighbor at the given offset, which must not be (0, 0).
+ */
+constexpr int directionOf(const short& rowOffset, const short& colOffset) {
+	const int position = (rowOffset + 1) * 3 + colOffset + 1;
+	return position > 4 ? position - 1 : position;
+}
+
+/**
+ * @return the cells which are in both sets. Both must be relative to the same number cell (see PossibilitySet::relativeTo).
+ */
+constexpr uint8_t intersect(const uint8_t& a, const uint8_t& b) {
+	return a & b;
+}
+
+/**
+ * @return the cells which are in set a but not in set b. Both must be relative to the same number cell (see PossibilitySet::relativeTo).
+ */
+constexpr uint8_t subtract(const uint8_t& a, const uint8_t& b) {
+	return a & ~b;
+}
+
+inline short popcount(const uint8_t& set) {
+	return bitset<8>(set).count();
+}
 
+/**
+ * The hidden neighbors of a number cell which may hold its remaining mines, as a mask over the 8 neighbor directions.
+ */
 struct PossibilitySet {
-	short numAdjacentMines;
-	unordered_set<Solvercell*> possibilities;
+	short numAdjacentMines = 0;
+	uint8_t possibilities = 0;
+	
+	short size() const {
+		return popcount(possibilities);
+	}
+	
+	void insert(const int& direction) {
+		possibilities |= 1 << direction;
+	}
+	
+	void erase(const int& direction) {
+		possibilities &= ~(1 << direction);
+	}
+	
+	/**
+	 * @return the lowest direction in the set, which must not be empty.
+	 */
+	int firstDirection() const {
+		return __builtin_ctz(possibilities);
+	}
 	
-	PossibilitySet(const short& desiredNumAdjacentMines
-	) :		numAdjacentMines(desiredNumAdjacentMines) {}
+	/**
+	 * Re-express this set relative to another number cell, which is (rowOffset, colOffset) away from this set's number cell.
+	 * @param outside receives the cells of this set which are not neighbors of the other number cell, as directions from this set's number cell.
+	 * @return the cells of this set which are neighbors of the other number cell, as directions from it.
+	 */
+	uint8_t relativeTo(const short& rowOffset, const short& colOffset, uint8_t& outside) const {
+		uint8_t inside = 0;
+		outside = 0;
+		for(uint8_t remaining = possibilities; remaining != 0; remaining &= remaining - 1) {
+			const int direction = __builtin_ctz(remaining);
+			const short relativeRow = NEIGHBOR_ROW_OFFSETS[direction] - rowOffset;
+			const short relativeCol = NEIGHBOR_COL_OFFSETS[direction] - colOffset;
+			if(abs(relativeRow) <= 1 && abs(relativeCol) <= 1 && (relativeRow != 0 || relativeCol != 0)) {
+				inside |= 1 << directionOf(relativeRow, relativeCol);
+			}
+			else {
+				outside |= 1 << direction;
+			}
+		}
+		return inside;
+	}
 };
 
 class Solvercell final : public Cell {
 	friend class Solver;
+	friend struct SolvercellIndex;
 	friend ostream& operator<<(ostream& outputStream, const Solvercell& cell);
 	
 	private:
 		State state;
-		PossibilitySet* possibilitySet;
+		bool hasPossibilitySet;				//whether possibilitySet has been built, which happens once a NUMBER cell's neighbors all have a state
+		bool isQueued;						//whether this cell is in the solver's ready queue
+		uint32_t slot;						//position of this cell's node in the working list: its index on the board, or in sparse mode, a number which is handed on once the cell is retired
+		PossibilitySet possibilitySet;
 		
 		Solvercell(	const short& desiredRow,
-					const short& desiredCol
+					const short& desiredCol,
+					const uint32_t& desiredSlot
 		) :		Cell(desiredRow, desiredCol),
 				state(UNINITIALIZED),
-				possibilitySet(nullptr) {}
-	
-	public:
-		~Solvercell() {
-			delete possibilitySet;
-		}
+				hasPossibilitySet(false),
+				isQueued(false),
+				slot(desiredSlot) {}
 };
 
 ostream& operator<<(ostream& outputStream, const Solvercell& cell) {
-	outputStream << "Data for cell [" << cell.row << ", " << cell.col << "]: Possibility Set with " << cell.possibilitySet->numAdjacentMines << " mines in the following cells:" << endl;
-	for(const auto& possibility : cell.possibilitySet->possibilities) {
-		outputStream << "\t[" << possibility->row << ", " << possibility->col << "]" << endl;
+	outputStream << "Data for cell [" << cell.row << ", " << cell.col << "]: Possibility Set with " << cell.possibilitySet.numAdjacentMines << " mines in the following cells:" << endl;
+	for(int direction = 0; direction < 8; direction++) {
+		if(cell.possibilitySet.possibilities & (1 << direction)) {
+			outputStream << "\t[" << cell.row + NEIGHBOR_ROW_OFFSETS[direction] << ", " << cell.col + NEIGHBOR_COL_OFFSETS[direction] << "]" << endl;
+		}
 	}
 	return outputStream;
 }
 
+/**
+ * Maps a solver cell to its slot, so that the working list can keep its nodes in a vector instead of a hash map
+ */
+struct SolvercellIndex {
+	uint32_t operator()(const Solvercell* const& cell) const {
+		return cell->slot;
+	}
+};
+
 class Solver final : public Field {
 	private:
-		// Reference to the underlying game that is being played
+		// The underlying game that is being played (a pointer, so that reset() can move the solver on to another game)
 		// When moves are made by the solver, they are done directly to this object,
 		// and the results of those moves are populated in the result container for callers to inspect/display.
-		Minefield& minefield;
+		Minefield* minefield;
+		
+		// Whether the solver is in sparse mode, where it only keeps the cells it is working with (see sparseCells), instead of every cell of the board (see cells)
+		const bool sparse;
 		
 		// Holds a list of solver cells which are still unsolved.
 		// Solved cells get removed as data is processed, and new cells are added as cells on the board are revealed.
-		partitioned_value_reorderable_list<Solvercell*> workingList;
+		indexed_partitioned_value_reorderable_list<Solvercell*, SolvercellIndex> workingList;
+		
+		// Holds the solver cells (in dense mode, all of them, allocated at once when the solver is created), which are all released at once when the solver is destroyed
+		// Solver cells are trivially destructible, so nothing needs to be done for each cell.
+		pmr::monotonic_buffer_resource arena;
+		
+		// Holds pointers to all solver cells, indexed the same way as the minefield's cells (row * cols + col). Empty in sparse mode
+		vector<Solvercell*> cells;
+		
+		// In sparse mode, holds the cells the solver is working with, by index: the number cells in the working list, and those solved since the last call to retireCells().
+		// The solver knows nothing about any other cell beyond what the minefield shows, so their states are read from the minefield instead (see stateOf).
+		unordered_map<int, Solvercell*> sparseCells;
+		vector<Solvercell*> retirementCandidates;	//sparse cells which may no longer be needed, because they were created or solved since the last call to retireCells()
+		vector<Solvercell*> retiredCells;			//sparse cells which were retired, whose memory and slots are reused before the arena is asked for more
+		uint32_t numSlots = 0;						//number of sparse cells allocated from the arena
+		
+		// Holds the cells of the working list whose sets determine a move on their own (all of their cells are safe, or all are mines), in the order they became so.
+		// Each cell is queued at most once at a time (see Solvercell::isQueued), and stays queued until its set is empty.
+		deque<Solvercell*> readyQueue;
+		
+		// Deduction stages which are run, in order, when the solver's own rules find no move
+		vector<unique_ptr<deduction::Stage>> stages;
 		
-		Solvercell* at(const short& row, const short& col) const {
-			return static_cast<Solvercell*>(Field::at(row, col));
+		// Moves found by a deduction stage which have not been made yet, as cell indices, and whether the cell is a mine
+		deque<pair<int, bool>> pendingDeductions;
+		
+		// What first made the possibility sets inconsistent, or empty if nothing has
+		string inconsistency;
+		
+		/**
+		 * Record that the possibility sets have become inconsistent, instead of throwing in the middle of an update. Only the first reason is kept.
+		 */
+		void markInconsistent(const char* reason) {
+			if(inconsistency.empty()) {
+				inconsistency = reason;
+			}
+		}
+		
+		/**
+		 * @return the status of a move which has just been made and processed.
+		 */
+		StepStatus statusAfterMove() const {
+			return inconsistency.empty() ? MOVED : INCONSISTENT;
+		}
+		
+		/**
+		 * Report a failed attempt to move the way the throwing API does.
+		 */
+		void throwIfFailed(const StepStatus& status) const {
+			switch(status) {
+				case STUCK:
+					throw NoValidMoveException();
+				case FINISHED:
+					throw logic_error("Step was requested when game is already finished");
+				case INCONSISTENT:
+					throw logic_error(inconsistency);
+				default:
+					break;
+			}
+		}
+		
+		/**
+		 * @return the state the solver gives a cell, going by what the minefield shows: its revealed state, or for a hidden cell, UNINITIALIZED (FAIL if it is flagged, as processResults records flagged cells).
+		 */
+		State minefieldStateOf(const int& index) const {
+			const Minecell cell = minefield->at(rowOf(index), colOf(index));
+			const State state = cell.getState();
+			return state == FAIL && !cell.isFlagged() ? UNINITIALIZED : state;
+		}
+		
+		/**
+		 * @return the solver cell with the given index. In sparse mode, a cell the solver does not have is created, with the state the minefield shows for it.
+		 */
+		Solvercell* cellAt(const int& index) {
+			if(!sparse) {
+				return cells[index];
+			}
+			
+			auto found = sparseCells.find(index);
+			if(found != sparseCells.end()) {
+				return found->second;
+			}
+			
+			Solvercell* cell;
+			if(retiredCells.empty()) {
+				cell = new(arena.allocate(sizeof(Solvercell), alignof(Solvercell))) Solvercell(rowOf(index), colOf(index), numSlots++);
+			}
+			else {
+				const uint32_t slot = retiredCells.back()->slot;
+				cell = new(retiredCells.back()) Solvercell(rowOf(index), colOf(index), slot);
+				retiredCells.pop_back();
+			}
+			cell->state = minefieldStateOf(index);
+			sparseCells.emplace(index, cell);
+			retirementCandidates.push_back(cell);
+			return cell;
+		}
+		
+		/**
+		 * @return the sparse cell with the given index, or nullptr if the solver does not have it.
+		 */
+		Solvercell* findCell(const int& index) const {
+			auto found = sparseCells.find(index);
+			return found != sparseCells.end() ? found->second : nullptr;
+		}
+		
+		/**
+		 * @return the state of the cell with the given index, without creating the cell in sparse mode.
+		 */
+		State stateOf(const int& index) const {
+			if(!sparse) {
+				return cells[index]->state;
+			}
+			
+			const Solvercell* cell = findCell(index);
+			return cell != nullptr ? cell->state : minefieldStateOf(index);
 		}
 		
-		unordered_set<Solvercell*> getAdjacentCells(Solvercell* cell) const {
-			unordered_set<Solvercell*> result;
-			for(auto& baseCell : Field::getAdjacentCells(cell)) {
-				result.insert(static_cast<Solvercell*>(baseCell));
+		/**
+		 * In sparse mode, retire every candidate cell which is neither in the working list nor in the ready queue. Queued candidates stay candidates until they leave the queue.
+		 * Must only be called where no solver cell pointers are held, other than by the working list and ready queue (i.e. once results are processed).
+		 */
+		void retireCells() {
+			size_t kept = 0;
+			for(Solvercell* cell : retirementCandidates) {
+				auto found = sparseCells.find(indexOf(cell->row, cell->col));
+				if(found == sparseCells.end() || found->second != cell) {
+					continue; //retired already, through an earlier entry of the list
+				}
+				
+				if(cell->isQueued) {
+					retirementCandidates[kept++] = cell;
+				}
+				else if(cell->state != NUMBER || !cell->hasPossibilitySet || cell->possibilitySet.size() == 0) {
+					sparseCells.erase(found);
+					retiredCells.push_back(cell);
+				}
 			}
-			return result;
+			retirementCandidates.resize(kept);
 		}
 		
-		unordered_set<Solvercell*> getAllCells() const {
-			unordered_set<Solvercell*> result;
-			for(auto& baseCell : Field::getAllCells()) {
-				result.insert(static_cast<Solvercell*>(baseCell));
+		/**
+		 * @return the index of the neighbor of the given cell in the given direction (see NEIGHBOR_ROW_OFFSETS), which must be on the board.
+		 */
+		int neighborOf(const Solvercell* cell, const int& direction) const {
+			return indexOf(cell->row + NEIGHBOR_ROW_OFFSETS[direction], cell->col + NEIGHBOR_COL_OFFSETS[direction]);
+		}
+		
+		/**
+		 * Call the given visitor with the index of every cell in the given number cell's possibility set.
+		 */
+		template<typename Visitor>
+		void forEachPossibility(const Solvercell* cell, Visitor&& visit) const {
+			for(uint8_t remaining = cell->possibilitySet.possibilities; remaining != 0; remaining &= remaining - 1) {
+				visit(neighborOf(cell, __builtin_ctz(remaining)));
 			}
-			return result;
+		}
+		
+		/**
+		 * Call the given visitor with every number cell adjacent to the cell with the given index whose possibility set has been built.
+		 * These are the only sets which can hold that cell, so they are the ones to update when it is revealed or flagged.
+		 * In sparse mode, a number cell the solver does not have is one whose set was solved (see retireCells), so it is skipped.
+		 */
+		template<typename Visitor>
+		void forEachAdjacentSet(const int& index, Visitor&& visit) {
+			forEachNeighbor(index, [&](const int& neighbor) {
+				Solvercell* cell = sparse ? findCell(neighbor) : cells[neighbor];
+				if(cell != nullptr && cell->state == NUMBER && cell->hasPossibilitySet) {
+					visit(cell);
+				}
+			});
 		}
 		
 		/**
 		 * Reveal one truly random space on the board. Used only for the first move of the game.
+		 * If the board was prepared ahead of time, its prepared cell (itself chosen at random) is revealed, so that the prepared board is used.
 		 * @param result points to a set where pointers to newly revealed cells will be placed.
 		 * @return the cell that was revealed.
 		 */
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* revealRandomSpace(ContainerType* const result) {
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell revealRandomSpace(ContainerType* const result) {
+			if(minefield->getPreparedStart() != Minecell()) {
+				return minefield->revealSpace(minefield->getPreparedStart(), result);
+			}
+			
 			//Construct a distribution which, when given a randomizer, can produce a number that refers to a unique cell in the field space
-			uniform_int_distribution<> generateNumberInRangeUsing(0, (minefield.getRows() * minefield.getCols()) - 1);
+			uniform_int_distribution<> generateNumberInRangeUsing(0, (minefield->getRows() * minefield->getCols()) - 1);
 			int index = generateNumberInRangeUsing(randomizer);
-			short candidateRow = index / minefield.getCols();
-			short candidateCol = index % minefield.getCols();
+			short candidateRow = rowOf(index);
+			short candidateCol = colOf(index);
 			
-			return minefield.revealSpace(candidateRow, candidateCol, result);
+			return minefield->revealSpace(candidateRow, candidateCol, result);
 		}
 		
 		/**
@@ -105,10 +368,10 @@ class Solver final : public Field {
 		 * @param result points to a set where pointers to newly revealed cells will be placed.
 		 * @return the given cell.
 		 */
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* revealSpaceFromPossibilities(Solvercell* cell, ContainerType* const result) {
-			Solvercell* cellToReveal = *(cell->possibilitySet->possibilities.begin());
-			return minefield.revealSpace(cellToReveal->row, cellToReveal->col, result);
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell revealSpaceFromPossibilities(Solvercell* cell, ContainerType* const result) {
+			const int cellToReveal = neighborOf(cell, cell->possibilitySet.firstDirection());
+			return minefield->revealSpace(rowOf(cellToReveal), colOf(cellToReveal), result);
 		}
 		
 		/**
@@ -116,247 +379,748 @@ class Solver final : public Field {
 		 * @param result points to a set where pointers to newly flagged/unflagged cells will be placed.
 		 * @return the given cell.
 		 */
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* flagSpaceFromPossibilities(Solvercell* cell, ContainerType* const result) {
-			Solvercell* cellToFlag = *(cell->possibilitySet->possibilities.begin());
-			return minefield.flagSpace(cellToFlag->row, cellToFlag->col, result);
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell flagSpaceFromPossibilities(Solvercell* cell, ContainerType* const result) {
+			const int cellToFlag = neighborOf(cell, cell->possibilitySet.firstDirection());
+			return minefield->flagSpace(rowOf(cellToFlag), colOf(cellToFlag), result);
+		}
+		
+		/**
+		 * Put a possibility set which has just changed where it belongs:
+		 *  - An empty set is solved, and leaves the working list right away.
+		 *  - A set of all safe cells (0 mines in N cells) or all mines (N mines in N cells) is immediately actionable:
+		 *    it joins the ready queue (unless it is queued already), and moves to the FRONT of the working list.
+		 *  - In all non-trivial cases, we still updated this solver cell, which means it is more valuable to compare with its neighbors than cells which have not been recently updated.
+		 *    Thus, move this solver cell to the MIDDLE of the working list, ahead of stale cases.
+		 */
+		void setUpdated(Solvercell* cell) {
+			const PossibilitySet& set = cell->possibilitySet;
+			if(set.size() == 0) {
+				LOGGER << "Cell [" << cell->row << ", " << cell->col << "] is solved, removing from working list" << endl;
+				workingList.erase(cell);
+				if(sparse) {
+					retirementCandidates.push_back(cell);
+				}
+				return;
+			}
+			
+			if(set.numAdjacentMines == 0 || set.numAdjacentMines == set.size()) {
+				workingList.move_to_partition_front(cell, LIST_PARTITION_FRONT);
+				if(!cell->isQueued) {
+					cell->isQueued = true;
+					readyQueue.push_back(cell);
+				}
+				return;
+			}
+			
+			workingList.move_to_partition_front(cell, LIST_PARTITION_MIDDLE);
 		}
 		
 		/**
 		 * When a cell is revealed to be a number or a blank space, remove it as a possibility for all other possibility sets, because we now know it cannot be a mine.
 		 * Reveal operations can turn cells from UNINITIALIZED to NUMBER, and we might be in the middle of a reveal operation. So we must be careful to only remove from possibility sets that are already initialized (check against nullptr)
 		 */
-		void removeSpaceFromAllAdjacentSolverCellPossibilitySets(Solvercell* cell) {
-			unordered_set<Solvercell*> neighbors = getAdjacentCells(cell);
-			for(Solvercell* neighbor : neighbors) {
-				if(neighbor->state == NUMBER && neighbor->possibilitySet != nullptr) {
-					neighbor->possibilitySet->possibilities.erase(cell);
-					
-					if(neighbor->possibilitySet->numAdjacentMines > neighbor->possibilitySet->possibilities.size()) {
-						throw logic_error("Possibility set contains more mines than possible cells after removing a cell from possibilites");
-					}
-					
-					// If possibilities size is reduced to (and now equals) mine count,
-					// we know the remaining possibilities (if any) are all mines and can be flagged.
-					// N mines in N spaces, this is a trivial case that is immediately actionable:
-					// Move this solver cell to the FRONT of the working list so that it gets processed next.
-					if(neighbor->possibilitySet->possibilities.size() == neighbor->possibilitySet->numAdjacentMines) {
-						workingList.move_to_partition_front(neighbor, LIST_PARTITION_FRONT);
-						continue;
-					}
-					
-					// In all non-trivial cases, we still updated this solver cell,
-					// which means it is more valuable to search next than cells which have not been recently updated.
-					// Thus, move this solver cell to the MIDDLE of the working list so that it gets processed after trivial cases but before stale cases.
-					workingList.move_to_partition_front(neighbor, LIST_PARTITION_MIDDLE);
+		void removeSpaceFromAllAdjacentSolverCellPossibilitySets(const int& index) {
+			forEachAdjacentSet(index, [&](Solvercell* neighbor) {
+				neighbor->possibilitySet.erase(directionOf(rowOf(index) - neighbor->row, colOf(index) - neighbor->col));
+				
+				if(neighbor->possibilitySet.numAdjacentMines > neighbor->possibilitySet.size()) {
+					markInconsistent("Possibility set contains more mines than possible cells after removing a cell from possibilites");
 				}
-			}
+				
+				// If possibilities size is reduced to (and now equals) mine count,
+				// we know the remaining possibilities (if any) are all mines and can be flagged.
+				setUpdated(neighbor);
+			});
 		}
 		
 		/**
 		 * When a cell is flagged, update it as a mine in all other possibility sets (credit each set with one mine, then remove the flagged space from each set).
 		 */
-		void flagSpaceInAllAdjacentSolverCellPossibilitySets(Solvercell* cell) {
-			unordered_set<Solvercell*> neighbors = getAdjacentCells(cell);
-			for(Solvercell* neighbor : neighbors) {
-				if(neighbor->state == NUMBER && neighbor->possibilitySet != nullptr) {
-					neighbor->possibilitySet->numAdjacentMines--; //decrement the number of adjacent mines (we found one)
-					neighbor->possibilitySet->possibilities.erase(cell); //remove the cell from the possibilites (the remaining mines must be in the other remaining cells)
-					
-					if(neighbor->possibilitySet->numAdjacentMines < 0) {
-						throw logic_error("Possibility set contains negative mine count after flagging a cell");
+		void flagSpaceInAllAdjacentSolverCellPossibilitySets(const int& index) {
+			forEachAdjacentSet(index, [&](Solvercell* neighbor) {
+				neighbor->possibilitySet.numAdjacentMines--; //decrement the number of adjacent mines (we found one)
+				neighbor->possibilitySet.erase(directionOf(rowOf(index) - neighbor->row, colOf(index) - neighbor->col)); //remove the cell from the possibilites (the remaining mines must be in the other remaining cells)
+				
+				if(neighbor->possibilitySet.numAdjacentMines < 0) {
+					markInconsistent("Possibility set contains negative mine count after flagging a cell");
+				}
+				
+				// If mine count is reduced to 0, we know the remaining possibilities (if any) are safe to reveal.
+				setUpdated(neighbor);
+			});
+		}
+		
+		/**
+		 * Compare the given cell's possibility set with every set that overlaps it, looking for one set contained in the other.
+		 * When set A is contained in set B, the cells of B outside A hold exactly (B's mines - A's mines) mines:
+		 * if that is zero they are all safe, and if it equals their count they are all mines.
+		 * Overlapping sets are found through the hidden cells they share: a set containing a hidden cell belongs to a number cell adjacent to it.
+		 * @param isMine is set to whether the returned cell is a mine.
+		 * @return the index of a cell whose state was deduced, or -1 if no deduction could be made.
+		 */
+		int findSubsetDeduction(Solvercell* cell, bool& isMine) {
+			// If smaller is contained in larger, check whether the cells in the difference are all safe or all mines
+			auto deduceFromDifference = [&](const Solvercell* smallerCell, const Solvercell* largerCell) -> int {
+				const PossibilitySet& smaller = smallerCell->possibilitySet;
+				const PossibilitySet& larger = largerCell->possibilitySet;
+				uint8_t outside;
+				const uint8_t smallerInLarger = smaller.relativeTo(largerCell->row - smallerCell->row, largerCell->col - smallerCell->col, outside);
+				if(outside != 0 || subtract(smallerInLarger, larger.possibilities) != 0) {
+					return -1;
+				}
+				
+				const uint8_t difference = subtract(larger.possibilities, smallerInLarger);
+				const short differenceSize = popcount(difference);
+				const short differenceMines = larger.numAdjacentMines - smaller.numAdjacentMines;
+				if(differenceSize == 0 || (differenceMines != 0 && differenceMines != differenceSize)) {
+					return -1;
+				}
+				
+				isMine = differenceMines != 0;
+				return neighborOf(largerCell, __builtin_ctz(difference));
+			};
+			
+			int deducedCell = -1;
+			vector<Solvercell*> comparedCells;
+			forEachPossibility(cell, [&](const int& possibility) {
+				forEachAdjacentSet(possibility, [&](Solvercell* other) {
+					if(deducedCell >= 0 || other == cell || find(comparedCells.begin(), comparedCells.end(), other) != comparedCells.end()) {
+						return;
 					}
+					comparedCells.push_back(other);
 					
-					// If mine count is reduced to 0, we know the remaining possibilities (if any) are safe to reveal.
-					// 0 mines in N spaces, this is a trivial case that is immediately actionable:
-					// move this solver cell to the FRONT of the working list so that it gets processed next.
-					if(neighbor->possibilitySet->numAdjacentMines == 0) {
-						workingList.move_to_partition_front(neighbor, LIST_PARTITION_FRONT);
-						continue;
+					deducedCell = deduceFromDifference(cell, other);
+					if(deducedCell < 0) {
+						deducedCell = deduceFromDifference(other, cell);
 					}
-					
-					// In all non-trivial cases, we still updated this solver cell,
-					// which means it is more valuable to search next than cells which have not been recently updated.
-					// Thus, move this solver cell to the MIDDLE of the working list so that it gets processed after trivial cases but before stale cases.
-					workingList.move_to_partition_front(neighbor, LIST_PARTITION_MIDDLE);
+				});
+			});
+			
+			return deducedCell;
+		}
+		
+		/**
+		 * Describe every possibility set in the working list as a constraint on the hidden cells.
+		 * @param interiorCells receives the indices of the hidden cells which appear in no possibility set. In sparse mode they are only counted, since they may be most of a huge board.
+		 */
+		deduction::Frontier describeFrontier(vector<int>& interiorCells) {
+			deduction::Frontier frontier;
+			vector<int> frontierCells;
+			for(Solvercell* cell : workingList) {
+				probability::Constraint constraint;
+				constraint.mines = cell->possibilitySet.numAdjacentMines;
+				forEachPossibility(cell, [&](const int& index) {
+					constraint.cells.push_back(index);
+					frontierCells.push_back(index);
+				});
+				frontier.constraints.push_back(constraint);
+			}
+			
+			if(sparse) {
+				// Every hidden cell that is not flagged is either on the frontier or in the interior
+				sort(frontierCells.begin(), frontierCells.end());
+				frontierCells.erase(unique(frontierCells.begin(), frontierCells.end()), frontierCells.end());
+				frontier.interiorCells = minefield->getRemainingSpaces() + minefield->getMineCount() - frontierCells.size();
+			}
+			else {
+				vector<bool> isOnFrontier(rows * cols, false);
+				for(const int& index : frontierCells) {
+					isOnFrontier[index] = true;
+				}
+				for(int index = 0; index < rows * cols; index++) {
+					if(cells[index]->state == UNINITIALIZED && !isOnFrontier[index]) {
+						interiorCells.push_back(index);
+					}
+				}
+				frontier.interiorCells = interiorCells.size();
+			}
+			frontier.remainingMines = minefield->getMineCount();
+			return frontier;
+		}
+		
+		/**
+		 * Pick a random interior cell (hidden, not flagged, and in no possibility set) in sparse mode, where they are not listed. There must be at least one.
+		 * @param frontierProbabilities has an entry for every cell in a possibility set.
+		 */
+		int randomInteriorCell(const probability::Probabilities& frontierProbabilities) const {
+			auto isInterior = [&](const int& index) {
+				return stateOf(index) == UNINITIALIZED && frontierProbabilities.cells.count(index) == 0;
+			};
+			
+			// On a huge board most hidden cells are usually interior, so a few random draws nearly always find one. Otherwise, take the first one after a random cell
+			uniform_int_distribution<int> randomIndex(0, rows * cols - 1);
+			for(int attempt = 0; attempt < 64; attempt++) {
+				const int index = randomIndex(randomizer);
+				if(isInterior(index)) {
+					return index;
+				}
+			}
+			const int start = randomIndex(randomizer);
+			for(int offset = 0; offset < rows * cols; offset++) {
+				const int index = (start + offset) % (rows * cols);
+				if(isInterior(index)) {
+					return index;
+				}
+			}
+			throw logic_error("Interior cells were counted, but none could be found");
+		}
+		
+		/**
+		 * Run the deduction stages in order until one of them finds moves, and queue those moves.
+		 * A stage which finds the frontier contradicts itself throws, which is recorded as an inconsistency like any other.
+		 */
+		void runDeductionStages() {
+			if(stages.empty()) {
+				return;
+			}
+			
+			vector<int> interiorCells;
+			const deduction::Frontier frontier = describeFrontier(interiorCells);
+			for(const unique_ptr<deduction::Stage>& stage : stages) {
+				deduction::Deductions deductions;
+				try {
+					deductions = stage->deduce(frontier);
+				} catch(const logic_error& e) {
+					markInconsistent(e.what());
+					return;
+				}
+				LOGGER << "Deduction stage \"" << stage->name() << "\" found " << deductions.safe.size() << " safe cell(s) and " << deductions.mines.size() << " mine(s)" << endl;
+				for(const int& cell : deductions.safe) {
+					pendingDeductions.emplace_back(cell, false);
+				}
+				for(const int& cell : deductions.mines) {
+					pendingDeductions.emplace_back(cell, true);
+				}
+				if(!deductions.empty()) {
+					return;
 				}
 			}
 		}
 		
-		template<typename ContainerType = unordered_set<Minecell*>>
+		template<typename ContainerType = unordered_set<Minecell>>
 		void processResults(ContainerType* const result) {
 			//Loop through results, set all cells with the appropriate state, and check how newly revealed or flagged cells affect PREEXISTING cells
-			for(Minecell* cell : *result) {
-				Solvercell* solvercell = at(cell->row, cell->col);
-				
-				State currentState = cell->getState();
-				solvercell->state = currentState;
+			for(const Minecell& cell : *result) {
+				State currentState = cell.getState();
+				// In sparse mode, only number cells are kept, since the state of any other cell can be read from the minefield
+				if(!sparse || currentState == NUMBER) {
+					cellAt(cell.getIndex())->state = currentState;
+				}
 				if(currentState == BLANK || currentState == NUMBER) {
-					removeSpaceFromAllAdjacentSolverCellPossibilitySets(solvercell);
+					removeSpaceFromAllAdjacentSolverCellPossibilitySets(cell.getIndex());
 				}
-				else if(cell->isFlagged()) {
-					flagSpaceInAllAdjacentSolverCellPossibilitySets(solvercell);
+				else if(cell.isFlagged()) {
+					flagSpaceInAllAdjacentSolverCellPossibilitySets(cell.getIndex());
 				}
 			}
 			
 			//Loop through results and initialize all NUMBER cells with possibility sets
 			//Pre-requirement: all result cells have a state. This is because we need to examine neighbors to build each possibility set.
 			//We can't be certain that a possibility set is initialized correctly unless we know that the number of uninitialized neighbor cells (and which cells they are) will not change.
-			for(Minecell* cell : *result) {
-				Solvercell* solvercell = at(cell->row, cell->col);
-				if(solvercell->state == NUMBER) {
-					PossibilitySet* newPossibilitySet = new PossibilitySet(cell->getNumber());
-					unordered_set<Solvercell*> neighbors = getAdjacentCells(solvercell);
-					for(Solvercell* neighbor : neighbors) {
-						if(neighbor->state == UNINITIALIZED) {
-							newPossibilitySet->possibilities.insert(neighbor);
+			for(const Minecell& cell : *result) {
+				if(cell.getState() == NUMBER) {
+					Solvercell* solvercell = cellAt(cell.getIndex());
+					PossibilitySet& newPossibilitySet = solvercell->possibilitySet;
+					newPossibilitySet.numAdjacentMines = cell.getNumber();
+					forEachNeighbor(cell.getIndex(), [&](const int& neighbor) {
+						if(stateOf(neighbor) == UNINITIALIZED) {
+							newPossibilitySet.insert(directionOf(rowOf(neighbor) - solvercell->row, colOf(neighbor) - solvercell->col));
 						}
-						else if(minefield.at(neighbor->row, neighbor->col)->isFlagged()) {
-							newPossibilitySet->numAdjacentMines--;
+						else if(minefield->at(rowOf(neighbor), colOf(neighbor)).isFlagged()) {
+							newPossibilitySet.numAdjacentMines--;
 						}
-					}
+					});
 					
-					if(newPossibilitySet->numAdjacentMines > newPossibilitySet->possibilities.size()) {
-						throw logic_error("Possibility set contains more mines than possible cells after construction");
+					if(newPossibilitySet.numAdjacentMines > newPossibilitySet.size()) {
+						markInconsistent("Possibility set contains more mines than possible cells after construction");
 					}
-					if(newPossibilitySet->numAdjacentMines > minefield.getMineCount()) {
-						throw logic_error("Possibility set contains more mines than are left in the game after construction");
+					if(newPossibilitySet.numAdjacentMines > minefield->getMineCount()) {
+						markInconsistent("Possibility set contains more mines than are left in the game after construction");
 					}
 					
-					solvercell->possibilitySet = newPossibilitySet;
+					solvercell->hasPossibilitySet = true;
 					
-					// Add this solver cell to the BACK of the working list
-					workingList.insert_to_partition_front(solvercell, LIST_PARTITION_BACK);
+					// Add this solver cell to the MIDDLE of the working list, so that it is compared with the sets it overlaps (or queue it, or drop it again if it has no possibilities)
+					workingList.insert_to_partition_front(solvercell, LIST_PARTITION_MIDDLE);
+					setUpdated(solvercell);
 				}
 			}
 			
 			//Log results
 			LOGGER << "Printing all number cells from processResults..." << endl;
 			for(const auto& minecell : *result) {
-				Solvercell* cell = at(minecell->row, minecell->col);
-				if(cell->state == NUMBER) {
-					LOGGER << "Processed result: " << *cell;
+				if(minecell.getState() == NUMBER) {
+					LOGGER << "Processed result: " << *cellAt(minecell.getIndex());
 				}
 			}
 			LOGGER << endl;
+			
+			retireCells();
 		}
 	
 	public:
 		/**
 		 * Constructor
+		 * @param desiredSparse is whether to run in sparse mode, keeping only the cells the solver is working with instead of every cell of the board.
+		 * Sparse mode makes the same moves, but its memory grows with the frontier instead of the board, which makes huge boards playable.
 		 */
-		Solver(Minefield& desiredMinefield
+		Solver(Minefield& desiredMinefield, const bool& desiredSparse
 		) :		Field(desiredMinefield.getRows(), desiredMinefield.getCols()),
-				minefield(desiredMinefield),
-				workingList(partitioned_value_reorderable_list<Solvercell*>(3))
+				minefield(&desiredMinefield),
+				sparse(desiredSparse),
+				workingList(3, desiredSparse ? 0 : desiredMinefield.getRows() * desiredMinefield.getCols(), SolvercellIndex()),
+				arena((desiredSparse ? 64 : desiredMinefield.getRows() * desiredMinefield.getCols()) * sizeof(Solvercell))
 		{
-			cells = vector<vector<Cell*>>();
+			static_assert(is_trivially_destructible<Solvercell>::value, "Solver cells are released with the arena, without being destroyed");
+			if(sparse) {
+				return;
+			}
+			
+			cells.reserve(rows * cols);
 			for(short row = 0; row < rows; row++) {
-				cells.push_back(vector<Cell*>());
 				for(short col = 0; col < cols; col++) {
-					cells.at(row).push_back(new Solvercell(row, col));
+					cells.push_back(new(arena.allocate(sizeof(Solvercell), alignof(Solvercell))) Solvercell(row, col, indexOf(row, col)));
 				}
 			}
 		}
+		
+		/**
+		 * Constructor. Boards of at least SPARSE_THRESHOLD cells are solved in sparse mode.
+		 */
+		Solver(Minefield& desiredMinefield
+		) :		Solver(desiredMinefield, desiredMinefield.getRows() * desiredMinefield.getCols() >= SPARSE_THRESHOLD) {}
+		
+		Solver(const Solver&) = delete;
+		void operator=(const Solver&) = delete;
+		
+		/**
+		 * Start over on another game, e.g. the next game of a batch, or the next candidate board during generation, without allocating anything again.
+		 * Every cell goes back to unknown, and the deduction stages forget what they learned about the previous game (the stages themselves are kept).
+		 * This is also the way out of an INCONSISTENT solver.
+		 * @param desiredMinefield must have the same dimensions as the minefield this solver was created for.
+		 */
+		void reset(Minefield& desiredMinefield) {
+			if(desiredMinefield.getRows() != rows || desiredMinefield.getCols() != cols) {
+				throw invalid_argument("Solver can only be reset for a minefield with the same dimensions");
+			}
+			
+			minefield = &desiredMinefield;
+			for(Solvercell* cell : cells) {
+				cell->state = UNINITIALIZED;
+				cell->hasPossibilitySet = false;
+				cell->isQueued = false;
+				cell->possibilitySet = PossibilitySet();
+			}
+			for(const pair<const int, Solvercell*>& entry : sparseCells) {
+				retiredCells.push_back(entry.second);
+			}
+			sparseCells.clear();
+			retirementCandidates.clear();
+			workingList.clear();
+			readyQueue.clear();
+			pendingDeductions.clear();
+			inconsistency.clear();
+			for(const unique_ptr<deduction::Stage>& stage : stages) {
+				stage->forget();
+			}
+		}
+		
+		/**
+		 * Add a deduction stage, to be run when the solver's own rules find no move. Stages run in the order they were added, and later stages only run when earlier ones find nothing.
+		 */
+		void addStage(unique_ptr<deduction::Stage> stage) {
+			stages.push_back(move(stage));
+		}
 	
 		/**
-		 * Advance the solver one step, i.e. make one game move
+		 * Advance the solver one step, i.e. make one game move, without throwing
 		 * @param result points to a set where pointers to newly revealed cells will be placed.
 		 * It is a required parameter for the solver, because the solver must recieve the results of an operation in order to act on the knowledge contained therein.
-		 * @return the cell that was acted upon.
+		 * @param actedOn is set to the cell that was acted upon, if a move was made.
+		 * @return MOVED, or why no move was made (see StepStatus). A move which leaves the sets inconsistent returns INCONSISTENT.
 		 */
-		template<typename ContainerType = unordered_set<Minecell*>>
-		Minecell* step(ContainerType* const result) {
-			if(minefield.getGameStatus() == WON || minefield.getGameStatus() == LOST) {
-				throw logic_error("Step was requested when game is already finished");
+		template<typename ContainerType = unordered_set<Minecell>>
+		StepStatus tryStep(ContainerType* const result, Minecell& actedOn) {
+			if(!inconsistency.empty()) {
+				return INCONSISTENT;
+			}
+			if(minefield->getGameStatus() == WON || minefield->getGameStatus() == LOST) {
+				return FINISHED;
 			}
 			
-			if(minefield.getGameStatus() == UNSTARTED) {
+			if(minefield->getGameStatus() == UNSTARTED) {
 				LOGGER << "First move of the game: revealing a random space..." << endl;
-				Minecell* resultingCell = revealRandomSpace(result);
+				actedOn = revealRandomSpace(result);
 				processResults(result);
-				return resultingCell;
+				return statusAfterMove();
 			}
 			
-			// Loop through all possibility sets in the working list,
-			// looking for cases where we can immediately make a game move,
-			// or use logic to simplify the working list to iterate again
-			LOGGER << "Examining all possibility sets..." << endl;
-			auto currentSolvercellIterator = workingList.begin();
-			while(currentSolvercellIterator != workingList.end()) {
-				Solvercell* currentSolvercell = *currentSolvercellIterator;
-				PossibilitySet* possibilitySet = currentSolvercell->possibilitySet;
-				LOGGER << "Examining set: " << *currentSolvercell << endl;
+			// Take the next immediately actionable set from the ready queue.
+			// Sets are queued as soon as an update makes them actionable, and solved sets leave the working list as soon as they are emptied,
+			// so the next trivial move is found without walking the working list.
+			LOGGER << "Examining the ready queue..." << endl;
+			while(!readyQueue.empty()) {
+				Solvercell* currentSolvercell = readyQueue.front();
+				const PossibilitySet& possibilitySet = currentSolvercell->possibilitySet;
 				
-				//case 1: set has mine count of 0 && possibilities of size 0
-				//	 action: cell is solved, remove it from working list, and continue looping
-				if(possibilitySet->numAdjacentMines == 0 && possibilitySet->possibilities.size() == 0) {
-					LOGGER << "Cell is solved, removing from working list and continuing..." << endl;
-					currentSolvercellIterator = workingList.erase(currentSolvercellIterator); //iterator is advanced to the next cell in the working list
+				//case 1: set has possibilities of size 0
+				//	 action: cell is solved (and already out of the working list), so drop it from the queue and continue looping
+				if(possibilitySet.size() == 0) {
+					readyQueue.pop_front();
+					currentSolvercell->isQueued = false;
 					continue;
 				}
+				LOGGER << "Examining set: " << *currentSolvercell << endl;
 				
 				//case 2: set has mine count of 0
-				//	 action: reveal any (aka first) cell in the set, process results, and return. Set is kept at front position in the list.
-				if(possibilitySet->numAdjacentMines == 0) {
+				//	 action: reveal any (aka first) cell in the set, process results, and return. Set is kept at the front of the queue until it is empty.
+				if(possibilitySet.numAdjacentMines == 0) {
 					LOGGER << "Move found! All possibilities in this cell's set are safe to reveal." << endl << endl;
-					Minecell* resultingCell = revealSpaceFromPossibilities(currentSolvercell, result);
+					actedOn = revealSpaceFromPossibilities(currentSolvercell, result);
 					processResults(result);
-					return resultingCell;
+					return statusAfterMove();
+				}
+				
+				//case 3: set has positive mine count of N && set has possibilities of size N (the only other way a set is queued)
+				//	 action: flag any (aka first) cell in the set, process results, and return. Set is kept at the front of the queue until it is empty.
+				if(minefield->getMineCount() == 0) {
+					markInconsistent("Set indicates that its cell(s) should be flagged, but total game mine count is already zero");
+					return INCONSISTENT;
 				}
 				
-				//case 3: set has positive mine count of N && set has possibilities of size N
-				//	 action: flag any (aka first) cell in the set, process results, and return. Set is kept at front position in the list.
-				if(possibilitySet->numAdjacentMines == possibilitySet->possibilities.size()) {
-					if(minefield.getMineCount() == 0) {
-						throw logic_error("Set indicates that its cell(s) should be flagged, but total game mine count is already zero");
+				LOGGER << "Move found! All possibilities in this cell's set should be flagged." << endl << endl;
+				actedOn = flagSpaceFromPossibilities(currentSolvercell, result);
+				processResults(result);
+				return statusAfterMove();
+			}
+			
+			//case 4: set is a subset of an overlapping set (or the other way around)
+			//	 action: reveal or flag a cell in the difference of the two sets, process results, and return.
+			//	 A pair of sets only needs rechecking when one of them changes, and changed sets are always moved to the FRONT or MIDDLE of the list.
+			//	 So only sets in those partitions are checked, and a set that gives no move is moved to the BACK until a neighbor updates it again.
+			LOGGER << "Examining recently updated possibility sets for subsets..." << endl;
+			auto currentSolvercellIterator = workingList.partitions_begin(LIST_PARTITION_FRONT, LIST_PARTITION_BACK);
+			while(currentSolvercellIterator != workingList.partitions_end(LIST_PARTITION_BACK)) {
+				Solvercell* currentSolvercell = *currentSolvercellIterator;
+				++currentSolvercellIterator; //advance before the current set might be moved out of this range
+				
+				bool deducedMine;
+				const int deducedCell = findSubsetDeduction(currentSolvercell, deducedMine);
+				if(deducedCell >= 0) {
+					if(deducedMine && minefield->getMineCount() == 0) {
+						markInconsistent("Subset deduction indicates that a cell should be flagged, but total game mine count is already zero");
+						return INCONSISTENT;
 					}
 					
-					LOGGER << "Move found! All possibilities in this cell's set should be flagged." << endl << endl;
-					Minecell* resultingCell = flagSpaceFromPossibilities(currentSolvercell, result);
+					LOGGER << "Move found! Comparing with an overlapping set shows that [" << rowOf(deducedCell) << ", " << colOf(deducedCell) << "] " << (deducedMine ? "should be flagged." : "is safe to reveal.") << endl << endl;
+					actedOn = deducedMine
+							? minefield->flagSpace(rowOf(deducedCell), colOf(deducedCell), result)
+							: minefield->revealSpace(rowOf(deducedCell), colOf(deducedCell), result);
 					processResults(result);
-					return resultingCell;
+					return statusAfterMove();
 				}
 				
-				//case 4: otherwise
-				//	 action: check if the set is a subset of another set, and continue looping
-				//			   **only need to recheck for being a subset when nearby cells are updated**
-				//			instead of skipping already checked cells, just keep them at the back of the list and keep the front populated with cells that have had neighbor updates recently
-				//	 can try having this be a "do nothing" case at first, to see how well the other cases do at advancing the board
-				++currentSolvercellIterator;
+				workingList.move_to_partition_front(currentSolvercell, LIST_PARTITION_BACK);
+			}
+			
+			//case 5: the possibility sets taken together force the state of some cells, as found by a deduction stage
+			//	 action: reveal or flag one such cell, process results, and return. The stage's other moves stay queued for later steps, and are made once the cases above find no move.
+			//	 Queued moves stay valid as the board changes, but a reveal may have uncovered a queued cell already, so those are skipped.
+			while(!pendingDeductions.empty() && stateOf(pendingDeductions.front().first) != UNINITIALIZED) {
+				pendingDeductions.pop_front();
+			}
+			if(pendingDeductions.empty()) {
+				runDeductionStages();
+				if(!inconsistency.empty()) {
+					return INCONSISTENT;
+				}
+			}
+			while(!pendingDeductions.empty()) {
+				const pair<int, bool> deduction = pendingDeductions.front();
+				pendingDeductions.pop_front();
+				if(stateOf(deduction.first) != UNINITIALIZED) {
+					continue;
+				}
+				if(deduction.second && minefield->getMineCount() == 0) {
+					markInconsistent("Deduction stage indicates that a cell should be flagged, but total game mine count is already zero");
+					return INCONSISTENT;
+				}
+				
+				LOGGER << "Move found! A deduction stage shows that [" << rowOf(deduction.first) << ", " << colOf(deduction.first) << "] " << (deduction.second ? "should be flagged." : "is safe to reveal.") << endl << endl;
+				actedOn = deduction.second
+						? minefield->flagSpace(rowOf(deduction.first), colOf(deduction.first), result)
+						: minefield->revealSpace(rowOf(deduction.first), colOf(deduction.first), result);
+				processResults(result);
+				return statusAfterMove();
+			}
+			
+			// All cells have been examined, and no valid move was found with the information available to us
+			return STUCK;
+		}
+		
+		/**
+		 * Advance the solver one step, i.e. make one game move
+		 * @param result points to a set where pointers to newly revealed cells will be placed.
+		 * @return the cell that was acted upon.
+		 * @throws NoValidMoveException if no move can be made without guessing, or logic_error if the game is finished or the sets are inconsistent (see tryStep).
+		 */
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell step(ContainerType* const result) {
+			Minecell actedOn;
+			throwIfFailed(tryStep(result, actedOn));
+			return actedOn;
+		}
+		
+		/**
+		 * Make every move that a possibility set determines on its own (sets whose cells are all safe or all mines), without throwing.
+		 * Such sets are queued in readyQueue as soon as an update makes them so, and the queue is drained here without scanning the working list.
+		 * The moves' results are processed once, after the queue is drained, so each wave of moves costs one update rather than one update per move.
+		 * If no set determines a move on its own, one move is made through tryStep() instead.
+		 * @param result points to a set where pointers to newly revealed or flagged cells will be placed.
+		 * @param numMoves is set to the number of cells revealed or flagged.
+		 * @return MOVED, or why no move was made, as tryStep() does.
+		 */
+		template<typename ContainerType = unordered_set<Minecell>>
+		StepStatus tryStepAll(ContainerType* const result, size_t& numMoves) {
+			ContainerType wave;
+			StepStatus status = MOVED;
+			if(minefield->getGameStatus() == PLAYING && inconsistency.empty()) {
+				LOGGER << "Making every move determined by a single possibility set..." << endl;
+				while(!readyQueue.empty() && minefield->getGameStatus() == PLAYING) {
+					Solvercell* currentSolvercell = readyQueue.front();
+					readyQueue.pop_front();
+					currentSolvercell->isQueued = false;
+					const PossibilitySet& possibilitySet = currentSolvercell->possibilitySet;
+					
+					// Moves made earlier while draining the queue are not processed yet, so a set may still hold cells that were revealed or flagged through another set.
+					// Revealing a revealed cell does nothing, but flagging a flagged cell would unflag it, so those are skipped
+					if(possibilitySet.numAdjacentMines == 0) {
+						forEachPossibility(currentSolvercell, [&](const int& possibility) {
+							minefield->revealSpace(rowOf(possibility), colOf(possibility), &wave);
+						});
+					}
+					else if(possibilitySet.numAdjacentMines == possibilitySet.size()) {
+						forEachPossibility(currentSolvercell, [&](const int& possibility) {
+							if(minefield->at(rowOf(possibility), colOf(possibility)).isFlagged()) {
+								return;
+							}
+							if(minefield->getMineCount() == 0) {
+								markInconsistent("Set indicates that its cell(s) should be flagged, but total game mine count is already zero");
+								return;
+							}
+							minefield->flagSpace(rowOf(possibility), colOf(possibility), &wave);
+						});
+					}
+				}
 			}
 			
+			if(wave.empty()) {
+				Minecell actedOn;
+				status = tryStep(&wave, actedOn);
+			}
+			else {
+				LOGGER << "Made " << wave.size() << " move(s) in one pass." << endl << endl;
+				processResults(&wave);
+				status = statusAfterMove();
+			}
 			
-			//Maybe only do this if all other options are exhausted (since this is so computationally intensive)
-			//...but maybe you could do a "try it and see what happens approach"
-			//...whereby you loop through each possibility in each set and for every single one...
-			//	 - NOTE: a single space can be pointed to by multiple possibility sets (multiple number spaces). We don't need to check a space multiple times, since assuming it's a mine does the same thing regardless of who asked for it. (somehow keep track of spaces that we've examined already and skip them when they come up from a different set)
-			//	 - you create a copy of the ENTIRE solver (which will include all possibility sets) - would need a copy constructor that deeeeeep copies
-			//		  ...because we don't want the changes in a hypothetical to change the state of the real solver board, in case it was a mistake (the alternative is keeping a stack of all changes and unwinding the stack when we mess up)
-			//	 - you mark the one possibility we're examining as a mine
-			//	 - you continue stepping and solving AND SKIPPING REAL MINE FLAGS/REVEALS until an exception is thrown (somehow keep track of reveals that it wanted to do but can't because we're in simulator mode. If we keep algorithm the same but just skip interactions with the real minefield, then we will get stuck in an infinite loop of trying to reveal one space.)
-			//	 - you catch all logic_errors and if one was thrown, you're done with this whole loop scenario: you've found a safe space (by disproving its possibility as a mine) and can...
-			//		  ...action: reveal SPECIFIC cell in the set that was being examined, process results, and return. Set that contains the specific cell is kept at the same relative list position it was in.
+			for(const Minecell& cell : wave) {
+				result->insert(result->end(), cell);
+			}
+			numMoves = wave.size();
+			return status;
+		}
+		
+		/**
+		 * Make every move that a possibility set determines on its own, by draining the queue of such sets (see tryStepAll).
+		 * @param result points to a set where pointers to newly revealed or flagged cells will be placed.
+		 * @return the number of cells revealed or flagged.
+		 * @throws NoValidMoveException if no move can be made without guessing, as step() does.
+		 */
+		template<typename ContainerType = unordered_set<Minecell>>
+		size_t stepAll(ContainerType* const result) {
+			size_t numMoves = 0;
+			throwIfFailed(tryStepAll(result, numMoves));
+			return numMoves;
+		}
+		
+		/**
+		 * Call tryStepAll() until the game is won or lost or guessing is required, without throwing.
+		 * @param result points to a set where pointers to every cell revealed or flagged along the way will be placed.
+		 * @param isCancelled optionally stops the solver early, once it returns true. It is checked before each call to tryStepAll().
+		 * @return FINISHED once the game is won or lost, STUCK if guessing is required, INCONSISTENT, or MOVED if the solver was cancelled first.
+		 */
+		template<typename ContainerType = unordered_set<Minecell>>
+		StepStatus tryStepUntilStuck(ContainerType* const result, const function<bool()>& isCancelled = nullptr) {
+			size_t numMoves;
+			StepStatus status = MOVED;
+			while(status == MOVED && (!isCancelled || !isCancelled())) {
+				status = tryStepAll(result, numMoves);
+			}
+			return status;
+		}
+		
+		/**
+		 * Call stepAll() until the game is won or lost or guessing is required.
+		 * @param result points to a set where pointers to every cell revealed or flagged along the way will be placed.
+		 * @param isCancelled optionally stops the solver early, once it returns true. It is checked before each call to tryStepAll().
+		 * @return whether the solver stopped because guessing is required.
+		 * @throws logic_error if the sets are inconsistent.
+		 */
+		template<typename ContainerType = unordered_set<Minecell>>
+		bool stepUntilStuck(ContainerType* const result, const function<bool()>& isCancelled = nullptr) {
+			const StepStatus status = tryStepUntilStuck(result, isCancelled);
+			if(status == INCONSISTENT) {
+				throwIfFailed(status);
+			}
+			return status == STUCK;
+		}
+		
+		/**
+		 * Reveal the hidden cell which is least likely to be a mine, for when no move can be deduced (i.e. step() threw NoValidMoveException).
+		 * Mine probabilities are computed exactly from all possibility sets in the working list and the number of mines left in the game.
+		 * @param result points to a set where pointers to newly revealed cells will be placed.
+		 * @return the cell that was revealed.
+		 */
+		template<typename ContainerType = unordered_set<Minecell>>
+		Minecell guess(ContainerType* const result) {
+			if(minefield->getGameStatus() != PLAYING) {
+				return step(result);
+			}
 			
+			vector<int> interiorCells;
+			const deduction::Frontier frontier = describeFrontier(interiorCells);
+			const probability::Probabilities probabilities = probability::compute(frontier.constraints, frontier.interiorCells, frontier.remainingMines);
 			
-			// All cells have been examined, and no valid move was found with the information available to us
-			throw NoValidMoveException();
+			int safestCell = -1;
+			double safestProbability = 2;
+			for(const auto& cellProbability : probabilities.cells) {
+				if(cellProbability.second < safestProbability || (cellProbability.second == safestProbability && cellProbability.first < safestCell)) {
+					safestCell = cellProbability.first;
+					safestProbability = cellProbability.second;
+				}
+			}
+			if(frontier.interiorCells > 0 && probabilities.interior < safestProbability) {
+				safestCell = sparse
+						? randomInteriorCell(probabilities)
+						: interiorCells[uniform_int_distribution<size_t>(0, interiorCells.size() - 1)(randomizer)];
+				safestProbability = probabilities.interior;
+			}
+			
+			LOGGER << "No move can be deduced: guessing [" << rowOf(safestCell) << ", " << colOf(safestCell) << "], which is a mine with probability " << safestProbability << endl << endl;
+			Minecell resultingCell = minefield->revealSpace(rowOf(safestCell), colOf(safestCell), result);
+			if(minefield->getGameStatus() != LOST) {
+				processResults(result);
+			}
+			return resultingCell;
+		}
+		
+		/**
+		 * Continue advancing the solver until the game is won or lost or guessing is required, without throwing
+		 * @param isCancelled optionally stops the solver early, once it returns true. It is checked before each call to tryStepAll().
+		 * @return the status that stopped the solver, as tryStepUntilStuck() does. The game was won if it is FINISHED and the minefield says so.
+		 */
+		StepStatus trySolve(const function<bool()>& isCancelled = nullptr) {
+			vector<Minecell> resultVector;
+			return tryStepUntilStuck(&resultVector, isCancelled);
+		}
+		
+		/**
+		 * Reveal the given cell as the opening move, then continue advancing the solver until the game is won or lost or guessing is required, without throwing
+		 * @return the status that stopped the solver, as trySolve() does.
+		 */
+		StepStatus trySolve(const short& row, const short& col, const function<bool()>& isCancelled = nullptr) {
+			unordered_set<Minecell> resultSet;
+			minefield->revealSpace(row, col, &resultSet);
+			processResults(&resultSet);
+			if(!inconsistency.empty()) {
+				return INCONSISTENT;
+			}
+			return trySolve(isCancelled);
 		}
 		
 		/**
 		 * Continue advancing the solver until the game is won or lost or guessing is required
+		 * @param isCancelled optionally stops the solver early, once it returns true. It is checked before each call to tryStepAll().
 		 * @return whether the game was won.
+		 * @throws logic_error if the sets are inconsistent.
 		 */
-		bool solve() {
-			try {
-				do {
-					unordered_set<Minecell*> resultSet;
-					step(&resultSet);
-				} while(minefield.getGameStatus() == PLAYING);
-				return minefield.getGameStatus() == WON;
-			} catch(NoValidMoveException e) {
+		bool solve(const function<bool()>& isCancelled = nullptr) {
+			vector<Minecell> resultVector;
+			stepUntilStuck(&resultVector, isCancelled);
+			return minefield->getGameStatus() == WON;
+		}
+		
+		/**
+		 * Reveal the given cell as the opening move, then continue advancing the solver until the game is won or lost or guessing is required
+		 * @return whether the game was won.
+		 * @throws logic_error if the sets are inconsistent.
+		 */
+		bool solve(const short& row, const short& col, const function<bool()>& isCancelled = nullptr) {
+			const StepStatus status = trySolve(row, col, isCancelled);
+			if(status == INCONSISTENT) {
+				throwIfFailed(status);
+			}
+			return minefield->getGameStatus() == WON;
+		}
+		
+		/**
+		 * Repair a board that the solver has become stuck on, so that solving can resume from the current state instead of starting over.
+		 * One mine is moved from the stuck frontier (hidden cells next to unsolved number cells) to a hidden cell with no revealed neighbors.
+		 * Only the possibility sets of the revealed cells next to the mine's old position change, and they are requeued or moved up the working list like any other updated set.
+		 * @param view is the view of the board being generated, which must be the board this solver is playing.
+		 * @return whether a mine could be moved.
+		 */
+		bool relocateFrontierMine(BoardView& view) {
+			vector<int> sources;
+			for(Solvercell* cell : workingList) {
+				forEachPossibility(cell, [&](const int& possibility) {
+					if(view.isMine(rowOf(possibility), colOf(possibility))) {
+						sources.push_back(possibility);
+					}
+				});
+			}
+			sort(sources.begin(), sources.end());
+			sources.erase(unique(sources.begin(), sources.end()), sources.end());
+			
+			vector<int> targets;
+			for(int index = 0; index < rows * cols; index++) {
+				if(stateOf(index) != UNINITIALIZED || view.isMine(rowOf(index), colOf(index))) {
+					continue;
+				}
+				
+				bool isNextToRevealedCell = false;
+				forEachNeighbor(index, [&](const int& neighbor) {
+					const State neighborState = stateOf(neighbor);
+					isNextToRevealedCell = isNextToRevealedCell || neighborState == NUMBER || neighborState == BLANK;
+				});
+				if(!isNextToRevealedCell) {
+					targets.push_back(index);
+				}
+			}
+			
+			if(sources.empty() || targets.empty()) {
 				return false;
 			}
+			
+			const int source = sources[uniform_int_distribution<size_t>(0, sources.size() - 1)(view.getRandomizer())];
+			const int target = targets[uniform_int_distribution<size_t>(0, targets.size() - 1)(view.getRandomizer())];
+			LOGGER << "Solver is stuck: moving the mine at [" << rowOf(source) << ", " << colOf(source) << "] to [" << rowOf(target) << ", " << colOf(target) << "]" << endl;
+			view.relocateMine(rowOf(source), colOf(source), rowOf(target), colOf(target));
+			//Moves deduced for the old mine layout no longer hold, and neither does anything the deduction stages kept
+			pendingDeductions.clear();
+			for(const unique_ptr<deduction::Stage>& stage : stages) {
+				stage->forget();
+			}
+			
+			// The target has no revealed neighbors, so only the sets around the source know about the move: each has one fewer mine
+			forEachAdjacentSet(source, [&](Solvercell* neighbor) {
+				neighbor->possibilitySet.numAdjacentMines--;
+				setUpdated(neighbor);
+			});
+			
+			return true;
 		}
 };
 